@@ -31,6 +31,8 @@
 
 #include "MC20_Arduino_Interface.h"
 
+static uint32_t bytesSent = 0;
+static uint32_t bytesReceived = 0;
 
 void  MC20_init()
 {
@@ -60,7 +62,7 @@ int MC20_wait_readable (int wait_time)
 void MC20_flush_serial()
 {
     while(MC20_check_readable()){
-        serialMC20.read();
+        MC20_read_byte();
     }
 }
 
@@ -72,7 +74,7 @@ void MC20_read_buffer(char *buffer, int count, unsigned int timeout, unsigned in
     prevChar = 0;
     while(1) {
         while (MC20_check_readable()) {
-            char c = serialMC20.read();
+            char c = MC20_read_byte();
             prevChar = millis();
             buffer[i++] = c;
             if(i >= count)break;
@@ -95,15 +97,26 @@ void MC20_clean_buffer(char *buffer, int count)
     }
 }
 
+int MC20_read_byte(void)
+{
+    int c = serialMC20.read();
+
+    if(c >= 0){
+        bytesReceived++;
+    }
+    return c;
+}
+
 //HACERR quitar esta funcion ?
 void MC20_send_byte(uint8_t data)
 {
     serialMC20.write(data);
+    bytesSent++;
 }
 
 void MC20_send_char(const char c)
 {
-    serialMC20.write(c);
+    MC20_send_byte(c);
 }
 
 void MC20_send_cmd(const char* cmd)
@@ -139,6 +152,62 @@ void MC20_send_End_Mark(void)
     MC20_send_byte((char)26);
 }
 
+/* Binary payload, sent as is */
+void MC20_send_data(const uint8_t *data, size_t length)
+{
+    serialMC20.write(data, length);
+    bytesSent += length;
+}
+
+/* Read exactly count bytes, fewer only on timeout */
+int MC20_read_data(uint8_t *buffer, int count, unsigned int timeout)
+{
+    int i = 0;
+    unsigned long timerStart = millis();
+
+    while(i < count){
+        if(MC20_check_readable()){
+            buffer[i++] = MC20_read_byte();
+            continue;
+        }
+        if((unsigned long) (millis() - timerStart) > timeout * 1000UL){
+            break;
+        }
+    }
+    return i;
+}
+
+/* Read a decimal number, e.g. after "+QFOPEN: ". Leading spaces are skipped,
+ * the character after the last digit is consumed.
+ */
+boolean MC20_read_number(long *value, unsigned int timeout)
+{
+    unsigned long timerStart = millis();
+    bool negative = false;
+    bool digits = false;
+    long number = 0;
+
+    while((unsigned long) (millis() - timerStart) <= timeout * 1000UL){
+        if(!MC20_check_readable()){
+            continue;
+        }
+        char c = MC20_read_byte();
+        if(c >= '0' && c <= '9'){
+            number = number * 10 + (c - '0');
+            digits = true;
+        } else if(c == '-' && !digits && !negative){
+            negative = true;
+        } else if(c == ' ' && !digits && !negative){
+            continue;
+        } else {
+            break;
+        }
+    }
+    *value = negative ? -number : number;
+
+    return digits;
+}
+
 boolean MC20_wait_for_resp(const char* resp, DataType type, unsigned int timeout, unsigned int chartimeout, bool debug)
 {
     int len = strlen(resp);
@@ -148,7 +217,7 @@ boolean MC20_wait_for_resp(const char* resp, DataType type, unsigned int timeout
     prevChar = 0;
     while(1) {
         if(MC20_check_readable()) {
-            char c = serialMC20.read();
+            char c = MC20_read_byte();
             
             if(debug){
                 serialDebug.write(c);
@@ -188,3 +257,19 @@ boolean MC20_check_with_cmd(const __FlashStringHelper* cmd, const char *resp, Da
     MC20_send_cmd(cmd);
     return MC20_wait_for_resp(resp,type,timeout,chartimeout,debug);
 }
+
+uint32_t MC20_bytes_sent(void)
+{
+    return bytesSent;
+}
+
+uint32_t MC20_bytes_received(void)
+{
+    return bytesReceived;
+}
+
+void MC20_reset_traffic(void)
+{
+    bytesSent = 0;
+    bytesReceived = 0;
+}
@@ -61,6 +61,7 @@ int   MC20_wait_readable(int wait_time);
 void  MC20_flush_serial();
 void  MC20_read_buffer(char* buffer,int count,  unsigned int timeout = DEFAULT_TIMEOUT, unsigned int chartimeout = DEFAULT_INTERCHAR_TIMEOUT);
 void  MC20_clean_buffer(char* buffer, int count);
+int   MC20_read_byte(void);
 void  MC20_send_byte(uint8_t data);
 void  MC20_send_char(const char c);
 void  MC20_send_cmd(const char* cmd);
@@ -68,8 +69,16 @@ void  MC20_send_cmd(const __FlashStringHelper* cmd);
 void  MC20_send_cmd_P(const char* cmd);
 boolean  MC20_Test_AT(void);
 void  MC20_send_End_Mark(void);
+void  MC20_send_data(const uint8_t *data, size_t length);
+int   MC20_read_data(uint8_t *buffer, int count, unsigned int timeout = DEFAULT_TIMEOUT);
+boolean MC20_read_number(long *value, unsigned int timeout = DEFAULT_TIMEOUT);
 boolean MC20_wait_for_resp(const char* resp, DataType type, unsigned int timeout = DEFAULT_TIMEOUT, unsigned int chartimeout = DEFAULT_INTERCHAR_TIMEOUT, bool debug=false);
 boolean  MC20_check_with_cmd(const char* cmd, const char *resp, DataType type, unsigned int timeout = DEFAULT_TIMEOUT, unsigned int chartimeout = DEFAULT_INTERCHAR_TIMEOUT*5, bool debug=false);
 boolean  MC20_check_with_cmd(const __FlashStringHelper* cmd, const char *resp, DataType type, unsigned int timeout = DEFAULT_TIMEOUT, unsigned int chartimeout = DEFAULT_INTERCHAR_TIMEOUT, bool debug=false);
 
+/* UART traffic to and from the modem since the last reset, in bytes */
+uint32_t MC20_bytes_sent(void);
+uint32_t MC20_bytes_received(void);
+void  MC20_reset_traffic(void);
+
 #endif
@@ -0,0 +1,43 @@
+/*
+ * MC20_CRC.h
+ * A library for SeeedStudio GPS Tracker CRC helper
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_CRC_H__
+#define __MC20_CRC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** CRC-16/CCITT (polynomial 0x1021), start with 0xFFFF and chain calls to
+ *  cover several pieces
+ */
+uint16_t MC20_crc16(uint16_t crc, const uint8_t *data, size_t length);
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * MC20_Clock.cpp
+ * A library for SeeedStudio GPS Tracker 1PPS disciplined clock
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "MC20_Clock.h"
+
+#define NOMINAL_PERIOD_Q8   (1000000UL << 8)
+#define PERIOD_TOLERANCE    1000        // us per second a pulse train may be off, 1000 ppm
+#define PERIOD_BASELINE     1024        // pulses the period is measured over at most
+
+GNSS_Clock *GNSS_Clock::active = NULL;
+
+GNSS_Clock::GNSS_Clock()
+{
+    pulses = 0;
+    edgeMicros = 0;
+    edgeMillis = 0;
+    aligned = false;
+    basePulse = 0;
+    baseMicros = 0;
+    periodQ8 = NOMINAL_PERIOD_Q8;
+}
+
+/* Keep the ISR short, everything else is done in update() */
+void GNSS_Clock::onPulse(void)
+{
+    GNSS_Clock *clock = active;
+
+    if(NULL != clock){
+        clock->edgeMicros = micros();
+        clock->edgeMillis = millis();
+        clock->pulses++;
+    }
+}
+
+bool GNSS_Clock::begin(uint8_t pin)
+{
+    if(digitalPinToInterrupt(pin) == NOT_AN_INTERRUPT){
+        return false;
+    }
+    this->pin = pin;
+    active = this;
+    pinMode(pin, INPUT);
+    attachInterrupt(digitalPinToInterrupt(pin), onPulse, RISING);
+
+    return true;
+}
+
+void GNSS_Clock::end(void)
+{
+    detachInterrupt(digitalPinToInterrupt(pin));
+    active = NULL;
+}
+
+bool GNSS_Clock::update(const GNSS_Fix &fix)
+{
+    uint32_t edge, count, edgeMs;
+    uint32_t n, elapsed;
+
+    // Only whole-second epochs line up with a pulse
+    if(!(fix.flags & FIX_VALID) || !(fix.flags & FIX_HAS_DATE) || fix.msec != 0){
+        return false;
+    }
+
+    noInterrupts();
+    edge = edgeMicros;
+    count = pulses;
+    edgeMs = edgeMillis;
+    interrupts();
+
+    // The sentence comes a few hundred ms after its pulse, an older edge
+    // belongs to some other second
+    if(count == 0 || millis() - edgeMs >= 1000){
+        return false;
+    }
+
+    // MCU clock against the pulse train. The baseline restarts after a gap
+    // in the pulses, and is halved when it gets long so micros() can not wrap.
+    n = count - basePulse;
+    elapsed = edge - baseMicros;
+    if(basePulse == 0 || n == 0 ||
+       elapsed > n * (1000000UL + PERIOD_TOLERANCE) || elapsed < n * (1000000UL - PERIOD_TOLERANCE)){
+        basePulse = count;
+        baseMicros = edge;
+    } else if(n >= 16){
+        periodQ8 = (uint32_t)(((uint64_t)elapsed << 8) / n);
+        if(n >= PERIOD_BASELINE){
+            basePulse += n / 2;
+            baseMicros += (uint32_t)(((uint64_t)periodQ8 * (n / 2)) >> 8);
+        }
+    }
+
+    syncUtc = fix.time;
+    syncPulse = count;
+    syncMicros = edge;
+    syncMillis = edgeMs;
+    aligned = true;
+
+    return true;
+}
+
+bool GNSS_Clock::isSynced(void)
+{
+    // Later pulses are counted from the aligned one in micros(), so it is
+    // the age of the alignment that must stay clear of the wrap. The last
+    // pulse is never older than the aligned one.
+    return aligned && millis() - syncMillis < GNSS_CLOCK_HOLDOVER;
+}
+
+bool GNSS_Clock::now(uint32_t *seconds, uint32_t *microseconds)
+{
+    return toUTC(micros(), seconds, microseconds);
+}
+
+bool GNSS_Clock::toUTC(uint32_t timestamp, uint32_t *seconds, uint32_t *microseconds)
+{
+    uint32_t edge;
+    uint32_t wholeSeconds;
+    int64_t offset;
+
+    if(!isSynced()){
+        return false;
+    }
+    noInterrupts();
+    edge = edgeMicros;
+    interrupts();
+
+    // Whole seconds from the aligned pulse to the last one, rounded so a
+    // missed pulse does not matter
+    wholeSeconds = (uint32_t)((((uint64_t)(edge - syncMicros) << 8) + periodQ8 / 2) / periodQ8);
+
+    // Time since the last pulse in GNSS microseconds, negative for captures
+    // taken before it
+    offset = (int64_t)(int32_t)(timestamp - edge) * (int64_t)NOMINAL_PERIOD_Q8 / (int64_t)periodQ8;
+    while(offset < 0){
+        offset += 1000000;
+        wholeSeconds--;
+    }
+    *seconds = syncUtc + wholeSeconds + (uint32_t)(offset / 1000000);
+    *microseconds = (uint32_t)(offset % 1000000);
+
+    return true;
+}
+
+int32_t GNSS_Clock::drift(void)
+{
+    return (int32_t)(((int64_t)periodQ8 - (int64_t)NOMINAL_PERIOD_Q8) * 1000 / 256);
+}
@@ -0,0 +1,112 @@
+/*
+ * MC20_Clock.h
+ * A library for SeeedStudio GPS Tracker 1PPS disciplined clock
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_CLOCK_H__
+#define __MC20_CLOCK_H__
+
+#include <Arduino.h>
+#include "MC20_NMEA.h"
+
+/* How long the clock keeps running on micros() after the last alignment
+ * with a fix, ms. micros() wraps after 71 minutes, so this has to stay well
+ * below that.
+ */
+#define GNSS_CLOCK_HOLDOVER     (30*60000UL)
+
+/** UTC from the GNSS 1PPS pulse.
+ *  The rising edge of the pulse marks the start of a UTC second, the RMC
+ *  that follows it names that second. Between pulses time is interpolated
+ *  with micros(), corrected by the MCU clock error measured against the
+ *  pulse train.
+ *
+ *      clock.begin(PPS_PIN);     // after gnss.set1PPS(true)
+ *      clock.update(fix);        // from the fix callback
+ *      clock.now(&seconds, &microseconds);
+ */
+class GNSS_Clock
+{
+public:
+    GNSS_Clock();
+
+    /** Capture the pulse on pin, only one GNSS_Clock can be active
+     *  @returns
+     *      false if the pin has no external interrupt
+     */
+    bool begin(uint8_t pin);
+    void end(void);
+
+    /** Align the last pulse with the UTC of a fix, call it for every fix
+     *  @returns
+     *      true if the fix was used
+     */
+    bool update(const GNSS_Fix &fix);
+
+    /** Pulse aligned with UTC by update() within GNSS_CLOCK_HOLDOVER
+     */
+    bool isSynced(void);
+
+    /** Current UTC
+     *  @returns
+     *      false if not synced, outputs are left alone
+     */
+    bool now(uint32_t *seconds, uint32_t *microseconds);
+
+    /** UTC of an earlier micros() capture, e.g. taken in a sensor ISR
+     */
+    bool toUTC(uint32_t timestamp, uint32_t *seconds, uint32_t *microseconds);
+
+    /** MCU clock error against GNSS, parts per billion, positive when
+     *  micros() runs fast
+     */
+    int32_t drift(void);
+
+    volatile uint32_t pulses;       // rising edges seen
+
+private:
+    static void onPulse(void);
+    static GNSS_Clock *active;
+
+    uint8_t pin;
+    volatile uint32_t edgeMicros;   // micros() of the last edge
+    volatile uint32_t edgeMillis;
+
+    bool aligned;
+    uint32_t syncUtc;               // UTC second starting at edge syncPulse
+    uint32_t syncPulse;
+    uint32_t syncMicros;
+    uint32_t syncMillis;            // millis() of edge syncPulse
+
+    uint32_t baseMicros;            // baseline for the period measurement
+    uint32_t basePulse;
+    uint32_t periodQ8;              // micros() per GNSS second, Q8
+};
+
+#endif
@@ -366,3 +366,186 @@ bool GPSTracker::AT_PowerDown(void)
   return MC20_check_with_cmd("AT+QPOWD=1\n\r", "NORMAL POWER DOWN", CMD, 5, 2000, UART_DEBUG);
 }
 
+static void sendFileCommand(const char *command, const char *name, const char *tail)
+{
+  MC20_send_cmd(command);
+  MC20_send_cmd("\"");
+  MC20_send_cmd(name);
+  MC20_send_cmd("\"");
+  MC20_send_cmd(tail);
+}
+
+long GPSTracker::fileOpen(const char *name, MC20_FileMode mode)
+{
+  char tail[8];
+  long handle;
+
+  MC20_flush_serial();
+  sprintf(tail, ",%d\n\r", mode);
+  sendFileCommand("AT+QFOPEN=", name, tail);
+  if(!MC20_wait_for_resp("+QFOPEN: ", DATA, MC20_FILE_TIMEOUT) || !MC20_read_number(&handle)){
+    return -1;
+  }
+  if(!MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT)){
+    return -1;
+  }
+  return handle;
+}
+
+long GPSTracker::fileRead(long handle, uint8_t *buffer, long length)
+{
+  char cmd[40];
+  long total = 0;
+  long request, n;
+  uint8_t lf;
+
+  MC20_flush_serial();
+  while(total < length){
+    request = (length - total < MC20_FILE_CHUNK) ? length - total : MC20_FILE_CHUNK;
+    // CONNECT <n>\r\n<n bytes>\r\nOK, n is 0 at the end of the file
+    sprintf(cmd, "AT+QFREAD=%ld,%ld\n\r", handle, request);
+    MC20_send_cmd(cmd);
+    if(!MC20_wait_for_resp("CONNECT ", DATA, MC20_FILE_TIMEOUT) || !MC20_read_number(&n)){
+      return total > 0 ? total : -1;
+    }
+    MC20_read_data(&lf, 1);
+    if(MC20_read_data(buffer + total, n, MC20_FILE_TIMEOUT) != n){
+      return -1;
+    }
+    total += n;
+    if(!MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT)){
+      return -1;
+    }
+    if(n < request){
+      break;
+    }
+  }
+  return total;
+}
+
+long GPSTracker::fileWrite(long handle, const uint8_t *data, long length)
+{
+  char cmd[40];
+  long total = 0;
+  long n, written;
+
+  MC20_flush_serial();
+  while(total < length){
+    n = (length - total < MC20_FILE_CHUNK) ? length - total : MC20_FILE_CHUNK;
+    sprintf(cmd, "AT+QFWRITE=%ld,%ld\n\r", handle, n);
+    MC20_send_cmd(cmd);
+    if(!MC20_wait_for_resp("CONNECT", DATA, MC20_FILE_TIMEOUT)){
+      return -1;
+    }
+    // Straight from the caller's buffer
+    MC20_send_data(data + total, n);
+    if(!MC20_wait_for_resp("+QFWRITE: ", DATA, MC20_FILE_TIMEOUT) || !MC20_read_number(&written)){
+      return -1;
+    }
+    if(!MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT)){
+      return -1;
+    }
+    total += written;
+    if(written < n){
+      // File system full
+      break;
+    }
+  }
+  return total;
+}
+
+bool GPSTracker::fileSeek(long handle, long offset, MC20_FileOrigin origin)
+{
+  char cmd[48];
+
+  sprintf(cmd, "AT+QFSEEK=%ld,%ld,%d\n\r", handle, offset, origin);
+  return MC20_check_with_cmd(cmd, "OK\r\n", CMD, MC20_FILE_TIMEOUT);
+}
+
+bool GPSTracker::fileClose(long handle)
+{
+  char cmd[32];
+
+  sprintf(cmd, "AT+QFCLOSE=%ld\n\r", handle);
+  return MC20_check_with_cmd(cmd, "OK\r\n", CMD, MC20_FILE_TIMEOUT);
+}
+
+bool GPSTracker::fileDelete(const char *name)
+{
+  MC20_flush_serial();
+  sendFileCommand("AT+QFDEL=", name, "\n\r");
+  return MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT);
+}
+
+bool GPSTracker::fileUpload(const char *name, const uint8_t *data, long length)
+{
+  char tail[16];
+  long size;
+
+  MC20_flush_serial();
+  sprintf(tail, ",%ld\n\r", length);
+  sendFileCommand("AT+QFUPL=", name, tail);
+  if(!MC20_wait_for_resp("CONNECT", DATA, MC20_FILE_TIMEOUT)){
+    return false;
+  }
+  MC20_send_data(data, length);
+  if(!MC20_wait_for_resp("+QFUPL: ", DATA, MC20_FILE_TIMEOUT) || !MC20_read_number(&size)){
+    return false;
+  }
+  return MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT) && size == length;
+}
+
+long GPSTracker::fileDownload(const char *name, uint8_t *buffer, long size)
+{
+  long length = fileSize(name);
+  long stored = (length < size) ? length : size;
+  uint8_t skip;
+
+  if(length < 0){
+    return -1;
+  }
+  // CONNECT\r\n<data>+QFDWL: <size>,<checksum>, the size is needed to tell data from the trailer
+  sendFileCommand("AT+QFDWL=", name, "\n\r");
+  if(!MC20_wait_for_resp("CONNECT\r\n", DATA, MC20_FILE_TIMEOUT)){
+    return -1;
+  }
+  if(MC20_read_data(buffer, stored, MC20_FILE_TIMEOUT) != stored){
+    return -1;
+  }
+  for(long i = stored; i < length; i++){
+    if(MC20_read_data(&skip, 1, MC20_FILE_TIMEOUT) != 1){
+      return -1;
+    }
+  }
+  if(!MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT)){
+    return -1;
+  }
+  return stored;
+}
+
+long GPSTracker::fileSize(const char *name)
+{
+  long size;
+
+  // +QFLST: "<name>",<size>
+  MC20_flush_serial();
+  sendFileCommand("AT+QFLST=", name, "\n\r");
+  if(!MC20_wait_for_resp("\",", DATA, MC20_FILE_TIMEOUT) || !MC20_read_number(&size)){
+    return -1;
+  }
+  MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT);
+
+  return size;
+}
+
+bool GPSTracker::fileSpace(const char *storage, long *freeBytes, long *totalBytes)
+{
+  // +QFLDS: <free>,<total>
+  MC20_flush_serial();
+  sendFileCommand("AT+QFLDS=", storage, "\n\r");
+  if(!MC20_wait_for_resp("+QFLDS: ", DATA, MC20_FILE_TIMEOUT) ||
+     !MC20_read_number(freeBytes) || !MC20_read_number(totalBytes)){
+    return false;
+  }
+  return MC20_wait_for_resp("OK\r\n", CMD, MC20_FILE_TIMEOUT);
+}
@@ -43,6 +43,23 @@ enum Protocol {
     TCP    = 1,
     UDP    = 2,
 };
+
+/* AT+QFOPEN modes */
+enum MC20_FileMode {
+    MC20_FILE_OPEN      = 0,   // open, create if missing
+    MC20_FILE_CREATE    = 1,   // create, truncate if it exists
+    MC20_FILE_READ_ONLY = 2,
+};
+
+/* AT+QFSEEK origins */
+enum MC20_FileOrigin {
+    MC20_SEEK_SET = 0,
+    MC20_SEEK_CUR = 1,
+    MC20_SEEK_END = 2,
+};
+
+#define MC20_FILE_CHUNK     1024    // most bytes per AT+QFREAD / AT+QFWRITE
+#define MC20_FILE_TIMEOUT   5       // seconds
  
 class GPSTracker
 {
@@ -191,6 +208,65 @@ public:
      * Turn off module power buy AT commnad
      */
     bool AT_PowerDown(void);
+
+    /*
+        Modem file system, files on "UFS" (flash) or "RAM" (name prefix "RAM:")
+    */
+
+    /** Open a file on the modem
+     *  @param  name  e.g. "backlog.bin" or "RAM:payload.txt"
+     *  @returns
+     *      file handle, -1 on error
+     */
+    long fileOpen(const char *name, MC20_FileMode mode = MC20_FILE_OPEN);
+
+    /** Read from an open file, streamed in MC20_FILE_CHUNK pieces
+     *  @returns
+     *      bytes read, less than length at the end of the file, -1 on error
+     */
+    long fileRead(long handle, uint8_t *buffer, long length);
+
+    /** Write to an open file at its position
+     *  @returns
+     *      bytes written, -1 on error
+     */
+    long fileWrite(long handle, const uint8_t *data, long length);
+
+    /** Move the position of an open file
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool fileSeek(long handle, long offset, MC20_FileOrigin origin = MC20_SEEK_SET);
+
+    bool fileClose(long handle);
+
+    bool fileDelete(const char *name);
+
+    /** Create or replace a whole file in one transfer (AT+QFUPL)
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool fileUpload(const char *name, const uint8_t *data, long length);
+
+    /** Read a whole file in one transfer (AT+QFDWL)
+     *  @param  size  bytes available at buffer, the rest of the file is skipped
+     *  @returns
+     *      bytes stored in buffer, -1 on error
+     */
+    long fileDownload(const char *name, uint8_t *buffer, long size);
+
+    /** Size of a file
+     *  @returns
+     *      size in bytes, -1 if the file does not exist
+     */
+    long fileSize(const char *name);
+
+    /** Free and total space of a storage
+     *  @param  storage  "UFS" or "RAM"
+     */
+    bool fileSpace(const char *storage, long *freeBytes, long *totalBytes);
     
 // private:
     bool checkSIMStatus(void);
@@ -0,0 +1,162 @@
+/*
+ * MC20_Connection.cpp
+ * A library for SeeedStudio GPS Tracker TCP connection manager
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "MC20_Connection.h"
+
+TCPConnection::TCPConnection(GPRS &gprs, const char *host, int port) : gprs(gprs)
+{
+    this->host = host;
+    this->port = port;
+    socket = -1;
+    backoff = 0;
+    retryTime = 0;
+    lastActivity = 0;
+    wasConnected = false;
+    connects = 0;
+    failures = 0;
+    drops = 0;
+    messages = 0;
+    setupTime = 0;
+    setupBytes = 0;
+}
+
+uint32_t TCPConnection::setupTimePerMessage(void) const
+{
+    return messages > 0 ? setupTime / messages : setupTime;
+}
+
+void TCPConnection::maintain(void)
+{
+    gprs.poll();
+    if(wasConnected && !isConnected()){
+        drops++;
+        wasConnected = false;
+    }
+}
+
+/* One open attempt, unless still backing off from the last failure */
+bool TCPConnection::connect(void)
+{
+    uint32_t timerStart = millis();
+    uint32_t bytes = MC20_bytes_sent() + MC20_bytes_received();
+    bool ok;
+
+    if(backoff > 0 && (uint32_t)(millis() - retryTime) < backoff){
+        return false;
+    }
+
+    if(gprs.mux){
+        socket = gprs.openSocket(TCP, host, port);
+        ok = socket >= 0;
+    } else {
+        ok = gprs.connectTCP(host, port, 1);
+    }
+    setupTime += millis() - timerStart;
+    setupBytes += MC20_bytes_sent() + MC20_bytes_received() - bytes;
+
+    if(!ok){
+        failures++;
+        retryTime = millis();
+        backoff = (backoff == 0) ? TCP_BACKOFF_MIN : backoff * 2;
+        if(backoff > TCP_BACKOFF_MAX){
+            backoff = TCP_BACKOFF_MAX;
+        }
+        return false;
+    }
+    connects++;
+    backoff = 0;
+    wasConnected = true;
+    lastActivity = millis();
+
+    return true;
+}
+
+bool TCPConnection::checkConnection(void)
+{
+    maintain();
+    // A NAT or the server may have dropped an idle socket without a URC
+    if(isConnected() && (uint32_t)(millis() - lastActivity) > TCP_IDLE_CHECK){
+        lastActivity = millis();
+        if(!(gprs.mux ? gprs.isSocketConnected(socket) : gprs.isTCPConnected())){
+            drops++;
+            wasConnected = false;
+        }
+    }
+    return isConnected() || connect();
+}
+
+bool TCPConnection::sendData(const uint8_t *data, size_t length)
+{
+    return gprs.send(data, length, gprs.mux ? socket : -1);
+}
+
+void TCPConnection::closeLink(void)
+{
+    if(gprs.mux){
+        gprs.closeSocket(socket);
+    } else {
+        gprs.closeTCP();
+    }
+}
+
+bool TCPConnection::send(char *data)
+{
+    return send((const uint8_t *)data, strlen(data));
+}
+
+bool TCPConnection::send(const uint8_t *data, size_t length)
+{
+    if(!checkConnection()){
+        return false;
+    }
+    if(!sendData(data, length)){
+        // Maybe dropped since the last check: reopen, and retry once if no
+        // byte reached a ">" prompt, even one without SEND OK may have gone out
+        closeLink();
+        drops++;
+        wasConnected = false;
+        if(gprs.writtenBytes > 0 || !connect() || !sendData(data, length)){
+            return false;
+        }
+    }
+    messages++;
+    lastActivity = millis();
+
+    return true;
+}
+
+void TCPConnection::close(void)
+{
+    if(isConnected()){
+        closeLink();
+    }
+    wasConnected = false;
+}
@@ -0,0 +1,113 @@
+/*
+ * MC20_Connection.h
+ * A library for SeeedStudio GPS Tracker TCP connection manager
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_CONNECTION_H__
+#define __MC20_CONNECTION_H__
+
+#include "MC20_GPRS.h"
+
+#define TCP_BACKOFF_MIN     2000UL      // ms before the first retry
+#define TCP_BACKOFF_MAX     300000UL    // ms, retries back off up to 5 minutes
+#define TCP_IDLE_CHECK      60000UL     // ms idle before AT+QISTATE is asked again
+
+/** Persistent TCP connection.
+ *  Keeps one socket open across sends instead of a QIOPEN per transfer.
+ *  The socket is opened on the first send() and whenever it is found down,
+ *  either from the "CLOSED" URC (seen by GPRS::poll()), from AT+QISTATE
+ *  after a quiet spell, or from a failed send. Failed opens are retried
+ *  no sooner than an exponentially growing backoff, so send() returns at
+ *  once while the network is gone.
+ *
+ *  The setup cost (time and UART bytes of the opens) is kept apart from
+ *  the payload, setupTimePerMessage() shows how well it is amortized.
+ *
+ *  With GPRS::enableMux() the connection takes a free socket index and
+ *  other sockets can be open next to it.
+ */
+class TCPConnection
+{
+public:
+    /** @param  host  kept by pointer, must stay valid
+     */
+    TCPConnection(GPRS &gprs, const char *host, int port);
+
+    /** Send a string, connecting first if needed. A failed send is retried
+     *  once on a new connection, unless part of it was already accepted.
+     *  @returns
+     *      true on SEND OK
+     *      false if not connected (backing off) or the send failed
+     */
+    bool send(char *data);
+
+    /** Send binary data, see GPRS::send()
+     */
+    bool send(const uint8_t *data, size_t length);
+
+    /** Handle URCs, call it from loop() */
+    void maintain(void);
+
+    /** Close the socket, the next send() opens it again */
+    void close(void);
+
+    bool isConnected(void) const { return gprs.mux ? gprs.isSocketOpen(socket) : gprs.tcpConnected; }
+
+    /** Socket index with GPRS::enableMux(), -1 if not open
+     */
+    int socketIndex(void) const { return isConnected() ? socket : -1; }
+
+    /** ms spent opening connections per message sent */
+    uint32_t setupTimePerMessage(void) const;
+
+    /* Statistics */
+    uint32_t connects;      // successful opens
+    uint32_t failures;      // failed opens
+    uint32_t drops;         // connections found down after being up
+    uint32_t messages;      // successful sends
+    uint32_t setupTime;     // ms in AT+QIOPEN, failed ones included
+    uint32_t setupBytes;    // UART bytes of the opens
+
+private:
+    bool connect(void);
+    bool checkConnection(void);
+    bool sendData(const uint8_t *data, size_t length);
+    void closeLink(void);
+
+    GPRS &gprs;
+    const char *host;
+    int port;
+    int socket;             // index with GPRS::mux
+    uint32_t backoff;       // ms to wait after the next failure
+    uint32_t retryTime;     // millis() of the last failed open
+    uint32_t lastActivity;  // millis() of the last send or check
+    bool wasConnected;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * MC20_FixHistory.h
+ * A library for SeeedStudio GPS Tracker fix history
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_FIXHISTORY_H__
+#define __MC20_FIXHISTORY_H__
+
+#include <stdint.h>
+#include "MC20_NMEA.h"
+
+/* 19 bytes per fix, 256 fixes take 4.75 KB of the SAMD21's 32 KB */
+#ifndef GNSS_HISTORY_SIZE
+#define GNSS_HISTORY_SIZE   256
+#endif
+
+/** Fixed-capacity ring of recent fixes.
+ *  Fields are kept in separate arrays so a scan over one of them (a time
+ *  search, a distance sum) walks contiguous memory. Appending is O(1) and
+ *  overwrites the oldest fix once full; fixes must be appended in time
+ *  order, which keeps the ring sorted for findByTime().
+ *
+ *      GNSS_FixHistory<> history;
+ *      history.append(gnss.fix);
+ *      for(GNSS_FixHistory<>::iterator it = history.from(t); it != history.end(); ++it){
+ *          GNSS_Fix fix = *it;
+ *      }
+ */
+template<uint16_t N = GNSS_HISTORY_SIZE>
+class GNSS_FixHistory
+{
+public:
+    class iterator
+    {
+    public:
+        iterator(const GNSS_FixHistory *history, uint16_t index) : history(history), index(index) {}
+        GNSS_Fix operator*() const { return (*history)[index]; }
+        iterator &operator++() { index++; return *this; }
+        iterator &operator--() { index--; return *this; }
+        bool operator==(const iterator &other) const { return index == other.index; }
+        bool operator!=(const iterator &other) const { return index != other.index; }
+        uint16_t position(void) const { return index; }
+
+    private:
+        const GNSS_FixHistory *history;
+        uint16_t index;
+    };
+
+    GNSS_FixHistory() { clear(); }
+
+    void clear(void)
+    {
+        head = 0;
+        count = 0;
+    }
+
+    /** Append a fix, dropping the oldest one when full
+     *  @returns
+     *      true on success
+     *      false if the fix is older than the newest one stored
+     */
+    bool append(const GNSS_Fix &fix)
+    {
+        uint16_t slot;
+
+        if(count > 0 && fix.time < times[physical(count - 1)]){
+            return false;
+        }
+        if(count < N){
+            slot = physical(count);
+            count++;
+        } else {
+            slot = head;
+            head = (head + 1 == N) ? 0 : head + 1;
+        }
+
+        times[slot] = fix.time;
+        latitudes[slot] = fix.latitude;
+        longitudes[slot] = fix.longitude;
+        altitudes[slot] = fix.altitude;
+        speeds[slot] = fix.speed;
+        qualities[slot] = fix.quality;
+
+        return true;
+    }
+
+    uint16_t size(void) const { return count; }
+    uint16_t capacity(void) const { return N; }
+    bool empty(void) const { return count == 0; }
+    bool full(void) const { return count == N; }
+
+    /** Fix by age, 0 is the oldest and size() - 1 the newest.
+     *  Only the stored fields are filled in, the rest is zero.
+     */
+    GNSS_Fix operator[](uint16_t index) const
+    {
+        GNSS_Fix fix = GNSS_Fix();
+        uint16_t slot = physical(index);
+
+        fix.time = times[slot];
+        fix.latitude = latitudes[slot];
+        fix.longitude = longitudes[slot];
+        fix.altitude = altitudes[slot];
+        fix.speed = speeds[slot];
+        fix.quality = qualities[slot];
+        fix.flags = FIX_HAS_DATE | (fix.quality > 0 ? FIX_VALID : 0);
+
+        return fix;
+    }
+
+    /** Newest fix, or a zeroed one without FIX_VALID when empty */
+    GNSS_Fix latest(void) const
+    {
+        if(count == 0){
+            return GNSS_Fix();
+        }
+        return (*this)[count - 1];
+    }
+
+    /* Single fields without building a GNSS_Fix */
+    uint32_t timeAt(uint16_t index) const { return times[physical(index)]; }
+    int32_t  latitudeAt(uint16_t index) const { return latitudes[physical(index)]; }
+    int32_t  longitudeAt(uint16_t index) const { return longitudes[physical(index)]; }
+    int32_t  altitudeAt(uint16_t index) const { return altitudes[physical(index)]; }
+    uint16_t speedAt(uint16_t index) const { return speeds[physical(index)]; }
+    uint8_t  qualityAt(uint16_t index) const { return qualities[physical(index)]; }
+
+    /** Binary search for the first fix at or after time
+     *  @returns
+     *      its index, size() if every fix is older
+     */
+    uint16_t findByTime(uint32_t time) const
+    {
+        uint16_t low = 0;
+        uint16_t high = count;
+
+        while(low < high){
+            uint16_t middle = low + (high - low) / 2;
+            if(times[physical(middle)] < time){
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    /** Fix closest in time
+     *  @returns
+     *      false if the history is empty
+     */
+    bool findNearest(uint32_t time, GNSS_Fix *fix) const
+    {
+        uint16_t index;
+
+        if(count == 0){
+            return false;
+        }
+        index = findByTime(time);
+        if(index == count || (index > 0 && time - timeAt(index - 1) < timeAt(index) - time)){
+            index--;
+        }
+        *fix = (*this)[index];
+
+        return true;
+    }
+
+    iterator begin(void) const { return iterator(this, 0); }
+    iterator end(void) const { return iterator(this, count); }
+
+    /** Iterator to the first fix at or after time */
+    iterator from(uint32_t time) const { return iterator(this, findByTime(time)); }
+
+private:
+    /* Ring position of the index-th oldest fix, no '%' as the M0+ has no divider */
+    uint16_t physical(uint16_t index) const
+    {
+        uint32_t slot = (uint32_t)head + index;
+        return slot >= N ? slot - N : slot;
+    }
+
+    uint32_t times[N];
+    int32_t  latitudes[N];
+    int32_t  longitudes[N];
+    int32_t  altitudes[N];
+    uint16_t speeds[N];
+    uint8_t  qualities[N];
+
+    uint16_t head;      // slot of the oldest fix
+    uint16_t count;
+};
+
+#endif
@@ -0,0 +1,196 @@
+/*
+ * MC20_FlashStore.cpp
+ * A library for SeeedStudio GPS Tracker flash storage
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "MC20_FlashStore.h"
+#include "MC20_CRC.h"
+
+#if defined(ARDUINO_ARCH_SAMD)
+#include <Arduino.h>
+#endif
+
+#define STORE_MAGIC     0xA5
+#define ROW_PAGES       (FLASH_ROW_SIZE / FLASH_PAGE_SIZE)
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+static void flashEraseRow(const uint8_t *address)
+{
+    NVMCTRL->ADDR.reg = (uint32_t)address / 2;
+    NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | NVMCTRL_CTRLA_CMD_ER;
+    while(!NVMCTRL->INTFLAG.bit.READY);
+}
+
+static void flashWritePage(const uint8_t *address, const uint32_t *data)
+{
+    volatile uint32_t *dst = (volatile uint32_t *)address;
+
+    // Manual write: clear the page buffer, fill it, then write the page
+    NVMCTRL->CTRLB.bit.MANW = 1;
+    NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | NVMCTRL_CTRLA_CMD_PBC;
+    while(!NVMCTRL->INTFLAG.bit.READY);
+    for(uint8_t i = 0; i < FLASH_PAGE_SIZE / 4; i++){
+        dst[i] = data[i];
+    }
+    NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | NVMCTRL_CTRLA_CMD_WP;
+    while(!NVMCTRL->INTFLAG.bit.READY);
+}
+
+#else
+
+static void flashEraseRow(const uint8_t *address)
+{
+    memset((uint8_t *)address, 0xFF, FLASH_ROW_SIZE);
+}
+
+static void flashWritePage(const uint8_t *address, const uint32_t *data)
+{
+    memcpy((uint8_t *)address, data, FLASH_PAGE_SIZE);
+}
+
+#endif
+
+FlashStore::FlashStore(const uint8_t *region, uint32_t size)
+{
+    this->region = region;
+    pages = size / FLASH_PAGE_SIZE;
+    scanned = false;
+    latest = -1;
+    latestSequence = 0;
+}
+
+bool FlashStore::pageErased(uint16_t page) const
+{
+    const uint32_t *p = (const uint32_t *)header(page);
+
+    for(uint8_t i = 0; i < FLASH_PAGE_SIZE / 4; i++){
+        if(p[i] != 0xFFFFFFFF){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Find the newest valid record once, later writes keep track of it */
+void FlashStore::scan(void)
+{
+    scanned = true;
+    latest = -1;
+    latestSequence = 0;
+
+    for(uint16_t page = 0; page < pages; page++){
+        const Header *h = header(page);
+        uint16_t crc;
+
+        if(h->magic != STORE_MAGIC || h->length > FLASH_STORE_MAX_DATA){
+            continue;
+        }
+        crc = MC20_crc16(0xFFFF, (const uint8_t *)&h->sequence, sizeof(h->sequence));
+        crc = MC20_crc16(crc, &h->length, 1);
+        crc = MC20_crc16(crc, (const uint8_t *)(h + 1), h->length);
+        if(crc != h->crc){
+            continue;
+        }
+        if(latest < 0 || h->sequence > latestSequence){
+            latest = page;
+            latestSequence = h->sequence;
+        }
+    }
+}
+
+uint32_t FlashStore::sequence(void)
+{
+    if(!scanned){
+        scan();
+    }
+    return latestSequence;
+}
+
+bool FlashStore::read(void *data, uint8_t length)
+{
+    if(!scanned){
+        scan();
+    }
+    if(latest < 0 || header(latest)->length != length){
+        return false;
+    }
+    memcpy(data, header(latest) + 1, length);
+
+    return true;
+}
+
+bool FlashStore::write(const void *data, uint8_t length)
+{
+    uint32_t page[FLASH_PAGE_SIZE / 4];
+    Header *h = (Header *)page;
+    uint16_t next;
+
+    if(length > FLASH_STORE_MAX_DATA || pages < 2 * ROW_PAGES){
+        return false;
+    }
+    if(!scanned){
+        scan();
+    }
+
+    next = (latest + 1) % pages;
+    if(!pageErased(next)){
+        // Erase the next row whole, never the one holding the newest record
+        if(latest >= 0 && next / ROW_PAGES == latest / ROW_PAGES){
+            next = (next / ROW_PAGES + 1) * ROW_PAGES % pages;
+        }
+        next -= next % ROW_PAGES;
+        flashEraseRow(region + (uint32_t)next * FLASH_PAGE_SIZE);
+    }
+
+    memset(page, 0xFF, sizeof(page));
+    h->sequence = latestSequence + 1;
+    h->length = length;
+    h->magic = STORE_MAGIC;
+    memcpy(h + 1, data, length);
+    h->crc = MC20_crc16(MC20_crc16(MC20_crc16(0xFFFF, (const uint8_t *)&h->sequence, sizeof(h->sequence)), &h->length, 1),
+                        (const uint8_t *)(h + 1), length);
+    flashWritePage(region + (uint32_t)next * FLASH_PAGE_SIZE, page);
+
+    latest = next;
+    latestSequence = h->sequence;
+
+    return true;
+}
+
+void FlashStore::clear(void)
+{
+    for(uint16_t page = 0; page < pages; page += ROW_PAGES){
+        flashEraseRow(region + (uint32_t)page * FLASH_PAGE_SIZE);
+    }
+    latest = -1;
+    latestSequence = 0;
+    scanned = true;
+}
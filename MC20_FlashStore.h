@@ -0,0 +1,112 @@
+/*
+ * MC20_FlashStore.h
+ * A library for SeeedStudio GPS Tracker flash storage
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_FLASHSTORE_H__
+#define __MC20_FLASHSTORE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* SAMD21 NVM: written a page at a time, erased a row (4 pages) at a time */
+#define FLASH_PAGE_SIZE     64
+#define FLASH_ROW_SIZE      256
+
+/* Payload of one record, the rest of the page is the header */
+#define FLASH_STORE_MAX_DATA    (FLASH_PAGE_SIZE - 8)
+
+/** Reserve a flash region for a FlashStore, at least 2 rows.
+ *  On other targets the region is plain RAM so the code still runs on a PC.
+ *
+ *      FLASH_STORE_REGION(positionFlash, 8);
+ *      FlashStore positionStore(positionFlash, sizeof(positionFlash));
+ */
+#if defined(ARDUINO_ARCH_SAMD)
+#define FLASH_STORE_REGION(name, rows) \
+    __attribute__((__aligned__(FLASH_ROW_SIZE))) static const uint8_t name[(rows) * FLASH_ROW_SIZE] = {}
+#else
+#define FLASH_STORE_REGION(name, rows) \
+    __attribute__((__aligned__(FLASH_ROW_SIZE))) static uint8_t name[(rows) * FLASH_ROW_SIZE] = {}
+#endif
+
+/** Wear-levelled store for one small record.
+ *  Every write goes to the next page of the region, so a row is erased only
+ *  once per (rows * 4) writes. read() returns the newest record that passes
+ *  its CRC, a write cut by a reset leaves the previous one in place.
+ */
+class FlashStore
+{
+public:
+    /** @param  region  FLASH_STORE_REGION(), row aligned
+     *  @param  size    bytes, a multiple of FLASH_ROW_SIZE
+     */
+    FlashStore(const uint8_t *region, uint32_t size);
+
+    /** Read the newest record
+     *  @returns
+     *      true if a record of length bytes was found
+     *      false otherwise
+     */
+    bool read(void *data, uint8_t length);
+
+    /** Append a record, up to FLASH_STORE_MAX_DATA bytes
+     *  @returns
+     *      true on success
+     *      false if too long
+     */
+    bool write(const void *data, uint8_t length);
+
+    /** Erase the whole region
+     */
+    void clear(void);
+
+    /** Records written to this region so far, survives resets */
+    uint32_t sequence(void);
+
+private:
+    struct Header {
+        uint32_t sequence;
+        uint16_t crc;       // CRC-16/CCITT of sequence, length and data
+        uint8_t  length;
+        uint8_t  magic;
+    };
+
+    void scan(void);
+    bool pageErased(uint16_t page) const;
+    const Header *header(uint16_t page) const { return (const Header *)(region + (uint32_t)page * FLASH_PAGE_SIZE); }
+
+    const uint8_t *region;
+    uint16_t pages;
+    bool scanned;
+    int32_t latest;         // page of the newest record, -1 if none
+    uint32_t latestSequence;
+};
+
+#endif
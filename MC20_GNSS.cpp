@@ -90,6 +90,11 @@ bool GNSS::open_GNSS(void)
       delay(1000);
   }
 
+  // Only a real power up starts a TTFF measurement
+  if(errCounts > 0){
+    startTTFF();
+  }
+
   return true;
 }
 
@@ -105,61 +110,56 @@ bool GNSS::open_GNSS_EPO_quick_mode(void)
     return false;
   }
 
-  //
-  if(!settingContext()){
-    return false;
-  }
-
-  // Check network register status
-  if(!isNetworkRegistered()){
+  // Download EPO only if the loaded data runs out soon
+  if(!refreshEPO()){
     return false;
   }
 
-  // Check time synchronization status
-  if(!isTimeSynchronized()){
-    return true;  // Return true to work on 
+  // Classify the start once the EPO is in, a fresh download makes it one with EPO
+  if(ttffPending){
+    ttffWithEPO = isEPOValid();
   }
-
-  // Enable EPO funciton
-  if(!enableEPO()){
-    return false;
-  }
-
-  // Trigger EPO funciton
-  if(!triggerEPO()){
-    return false;
-  }
-
   return true;
 }
 bool GNSS::open_GNSS_EPO_LP_mode(void)
 {
-  //
-  if(!settingContext()){
+  // EPO before GNSS, so the receiver starts with it
+  if(!refreshEPO()){
     return false;
   }
 
-  // Check network register status
-  if(!isNetworkRegistered()){
+  //Open GNSS funtion
+  if(!open_GNSS()){
     return false;
   }
 
-  // Check time synchronization status
-  if(!isTimeSynchronized()){
-    //Open GNSS funtion
-    if(!open_GNSS()){
+  return true;
+}
+
+bool GNSS::open_GNSS_RL_mode(void)
+{
+  int errCounts = 0;
+  char buffer[64];
+  char str_lat[16];
+  char str_lon[16];
+
+  // Last known position, else the reference set by the sketch
+  loadLastPosition();
+
+  // Write in reference-location, latitude first
+  NMEA_Parser::formatCoordinate(str_lat, (int32_t)(ref_latitude * 10000000.0 + (ref_latitude < 0 ? -0.5 : 0.5)));
+  NMEA_Parser::formatCoordinate(str_lon, (int32_t)(ref_longitude * 10000000.0 + (ref_longitude < 0 ? -0.5 : 0.5)));
+  sprintf(buffer, "AT+QGREFLOC=%s,%s\n\r", str_lat, str_lon);
+  while(!MC20_check_with_cmd(buffer, "OK", CMD, 2, 2000, UART_DEBUG)){
+    errCounts++;
+    if(errCounts > 3)
+    {
       return false;
     }
-    return true;  // Return true to work on 
-  }
-
-  // Enable EPO funciton
-  if(!enableEPO()){
-    return false;
+    delay(1000);
   }
 
-  // Trigger EPO funciton
-  if(!triggerEPO()){
+  if(!refreshEPO()){
     return false;
   }
 
@@ -171,57 +171,86 @@ bool GNSS::open_GNSS_EPO_LP_mode(void)
   return true;
 }
 
-bool GNSS::open_GNSS_RL_mode(void)
+void GNSS::setPositionStore(FlashStore *store, uint32_t interval, uint32_t distance)
 {
-  int errCounts = 0;
-  char buffer[128];
-  MC20_clean_buffer(buffer, 128);
+  positionStore = store;
+  saveInterval = interval;
+  saveDistance = distance;
+}
 
-  //
-  if(!settingContext()){
+bool GNSS::loadLastPosition(void)
+{
+  GNSS_Fix saved;
+
+  if(NULL == positionStore || !positionStore->read(&saved, sizeof(saved))){
     return false;
   }
+  lastPosition = saved;
+  ref_latitude = saved.latitude / 10000000.0;
+  ref_longitude = saved.longitude / 10000000.0;
 
-  // Check network register status
-  if(!isNetworkRegistered()){
+  return true;
+}
+
+bool GNSS::saveLastPosition(void)
+{
+  if(NULL == positionStore || !(fix.flags & FIX_VALID)){
     return false;
   }
+  if(!positionStore->write(&fix, sizeof(fix))){
+    return false;
+  }
+  lastPosition = fix;
 
-  // Check time synchronization status
-  if(!isTimeSynchronized()){
-    //Open GNSS funtion
-    if(!open_GNSS()){
+  return true;
+}
+
+/* Wear levelling: a flash write per interval at most, and none while parked */
+bool GNSS::savePosition(void)
+{
+  // 1e-7 degree is 1.11 cm of latitude, 90 per metre; longitude is compared unscaled
+  int32_t threshold = saveDistance * 90L;
+  int32_t dLat = fix.latitude - lastPosition.latitude;
+  int32_t dLon = fix.longitude - lastPosition.longitude;
+
+  if(NULL == positionStore || !(fix.flags & FIX_VALID) || !(fix.flags & FIX_HAS_DATE)){
+    return false;
+  }
+  if(lastPosition.time != 0){
+    if(fix.time - lastPosition.time < saveInterval){
       return false;
     }
-    return true;  // Return true to work on 
-  }
-
-  // Write in reference-location
-  // sprintf(buffer, "AT+QGREFLOC=%f,%f\n\r", ref_longitude, ref_latitude);
-  sprintf(buffer, "AT+QGREFLOC=22.584322,113.966678\n\r\n\r");
-  if(!MC20_check_with_cmd("AT+QGREFLOC=22.584322,113.966678\n\r", "OK", CMD, 2, 2000, UART_DEBUG)){
-    errCounts++;
-    if(errCounts > 3)
-    {
+    if(dLat < threshold && dLat > -threshold && dLon < threshold && dLon > -threshold){
       return false;
     }
-    delay(1000);
   }
+  return saveLastPosition();
+}
 
-  // Enable EPO funciton
-  if(!enableEPO()){
+bool GNSS::setReferenceFromCell(void)
+{
+  char buffer[64];
+  char *p;
+  double lon, lat;
+
+  // +QCELLLOC: <longitude>,<latitude>
+  MC20_clean_buffer(buffer, sizeof(buffer));
+  MC20_send_cmd("AT+QCELLLOC=1\n\r");
+  MC20_read_buffer(buffer, sizeof(buffer), 10);
+  if(NULL == (p = strstr(buffer, "+QCELLLOC: "))){
     return false;
   }
-
-  // Trigger EPO funciton
-  if(!triggerEPO()){
+  p += 11;
+  lon = strtod(p, &p);
+  if(*p != ','){
     return false;
   }
-
-  //Open GNSS funtion
-  if(!open_GNSS()){
+  lat = strtod(p + 1, NULL);
+  if(lat == 0.0 && lon == 0.0){
     return false;
   }
+  ref_latitude = lat;
+  ref_longitude = lon;
 
   return true;
 }
@@ -257,6 +286,11 @@ bool GNSS::getCoordinate(void)
     {
       return false;
     }
+    if(nmeaTee != NULL){
+        for(char *c = buffer; *c != '\0'; c++){
+            nmeaTee(*c);
+        }
+    }
     while(buffer[i] != '\0'){
         if(buffer[i] ==  *(p+j)){
             j++;
@@ -325,6 +359,81 @@ bool GNSS::dataFlowMode(void)
     // return MC20_check_with_cmd("AT+QGNSSRD?\n\r", "OK", CMD);
 }
 
+bool GNSS::enableNMEAStream(bool enable)
+{
+  MC20_flush_serial();
+  if(!MC20_check_with_cmd(enable ? GNSS_NMEA_STREAM_ON : GNSS_NMEA_STREAM_OFF, "OK", CMD, 2, 2000, UART_DEBUG)){
+    return false;
+  }
+  nmea.reset();
+
+  return true;
+}
+
+void GNSS::setFixCallback(GNSS_FixCallback callback)
+{
+  fixCallback = callback;
+}
+
+void GNSS::setNMEATee(GNSS_ByteCallback callback)
+{
+  nmeaTee = callback;
+}
+
+void GNSS::setURCHandler(GNSS_LineCallback callback)
+{
+  urcHandler = callback;
+  urcLength = 0;
+}
+
+bool GNSS::readNMEAStream(void)
+{
+  bool ret = false;
+
+  while(MC20_check_readable()){
+    char c = MC20_read_byte();
+
+    if(feedNMEA(c)){
+      ret = true;
+    }
+    if(NULL == urcHandler){
+      continue;
+    }
+    if(c != '\r' && c != '\n'){
+      if(urcLength < sizeof(urcLine) - 1){
+        urcLine[urcLength++] = c;
+      }
+      continue;
+    }
+    if(urcLength > 0){
+      urcLine[urcLength] = '\0';
+      urcLength = 0;
+      // Called at once, "+RECEIVE" is followed by data the handler reads
+      if(NULL == strchr(urcLine, '$')){
+        urcHandler(urcLine);
+      }
+    }
+  }
+
+  return ret;
+}
+
+void GNSS::updateCoordinate(const GNSS_Fix &newFix)
+{
+  fix = newFix;
+  if(!(fix.flags & FIX_VALID)){
+    return;
+  }
+
+  // Keep the legacy members in step for code written against getCoordinate()
+  latitude = fix.latitude / 10000000.0;
+  longitude = fix.longitude / 10000000.0;
+  sprintf(North_or_South, "%c", fix.latitude < 0 ? 'S' : 'N');
+  sprintf(West_or_East, "%c", fix.longitude < 0 ? 'W' : 'E');
+  NMEA_Parser::formatCoordinate(str_latitude, fix.latitude);
+  NMEA_Parser::formatCoordinate(str_longitude, fix.longitude);
+}
+
 bool GNSS::settingContext(void)
 {
   int errCounts = 0;
@@ -421,198 +530,521 @@ bool GNSS::triggerEPO(void)
   return true;
 }
 
-uint8_t GNSS::getCheckSum(char *string)
+void GNSS::setEPOValidity(uint32_t validity, uint32_t margin)
 {
-  uint8_t XOR = 0;  
-  for (int i = 0; i < strlen(string); i++) 
-  {
-    XOR = XOR ^ string[i];
+  epoValidity = validity;
+  epoMargin = margin;
+}
+
+bool GNSS::isEPOValid(uint32_t margin)
+{
+  if(!epoLoaded || margin >= epoValidity){
+    return false;
   }
-  return (XOR/16)*10 + (XOR%16);
+  return (millis() - epoLoadedAt) / 1000UL < epoValidity - margin;
 }
 
-bool GNSS::enable_EASY(void)
+bool GNSS::refreshEPO(bool force)
 {
-  int errCounts = 0;
+  if(!force && isEPOValid(epoMargin)){
+    return true;
+  }
 
   //
-  if(!MC20_check_with_cmd("AT+QGNSSCMD=0,\"$PMTK869,1,1*35\"\n\r", "OK", CMD, 2, 2000, UART_DEBUG)){
-    errCounts++;
-    if(errCounts > 3)
-    {
-      return false;
-    }
-    delay(1000);
+  if(!settingContext()){
+    return false;
+  }
+
+  // Check network register status
+  if(!isNetworkRegistered()){
+    return false;
+  }
+
+  // Check time synchronization status
+  if(!isTimeSynchronized()){
+    return true;  // Return true to work on 
+  }
+
+  // Enable EPO funciton
+  if(!enableEPO()){
+    return false;
   }
 
+  // Trigger EPO funciton
+  if(!triggerEPO()){
+    return false;
+  }
+
+  epoLoaded = true;
+  epoLoadedAt = millis();
+
   return true;
 }
 
+bool GNSS::refreshEPOIfConnected(void)
+{
+  if(isEPOValid(EPO_OPPORTUNISTIC_MARGIN)){
+    return false;
+  }
+
+  // A local IP means the PDP context is up
+  if(!MC20_check_with_cmd("AT+QILOCIP\n\r", ".", CMD, 2, 2000, UART_DEBUG)){
+    return false;
+  }
+
+  return refreshEPO(true);
+}
 
-bool GNSS::enable_GLP(int enable, int save)
+void GNSS::startTTFF(void)
 {
-  char str_buf[11];
-  char buf_w[64];
-  char checkSum;
+  ttffPending = true;
+  ttffWithEPO = isEPOValid();
+  openedAt = millis();
+}
 
-  MC20_clean_buffer(str_buf, 11);
-  sprintf(str_buf, "PQGLP,W,%d,%d", enable, save);
-  checkSum = getCheckSum(str_buf);
+void GNSS::recordTTFF(void)
+{
+  GNSS_TTFF &stats = ttffWithEPO ? ttffFreshEPO : ttffNoEPO;
 
-  MC20_clean_buffer(buf_w, 64);
-  sprintf(buf_w, "AT+QGNSSCMD=0,\"$%s*%d\"", str_buf, checkSum);
+  ttffPending = false;
+  lastTTFF = millis() - openedAt;
+  if(stats.count == 0 || lastTTFF < stats.best){
+    stats.best = lastTTFF;
+  }
+  if(lastTTFF > stats.worst){
+    stats.worst = lastTTFF;
+  }
+  stats.count++;
+  stats.total += lastTTFF;
+}
+
+uint8_t GNSS::getCheckSum(const char *string)
+{
+  uint8_t XOR = 0;
+
+  if(*string == '$'){
+    string++;
+  }
+  // One pass, stops at the end of the body or at an existing "*hh"
+  while(*string != '\0' && *string != '*'){
+    XOR ^= *string++;
+  }
+  return XOR;
+}
+
+bool GNSS::sendMTKCommand(const char *body, int checkSum, unsigned int timeout)
+{
+  if(!writeMTKCommand(body, checkSum)){
+    return false;
+  }
+  return waitForMTKAck(body, timeout) == MTK_ACK_SUCCESS;
+}
+
+bool GNSS::writeMTKCommand(const char *body, int checkSum)
+{
+  char buf_w[GNSS_MTK_CMD_LEN];
+
+  if(checkSum < 0){
+    checkSum = getCheckSum(body);
+  }
+  if(snprintf(buf_w, sizeof(buf_w), "AT+QGNSSCMD=0,\"$%s*%02X\"\n\r", body, checkSum) >= (int)sizeof(buf_w)){
+    return false;
+  }
 
-    //
   MC20_send_cmd(buf_w);
-  if(!MC20_check_with_cmd("\n\r", "+QGNSSCMD: $PQGLP,W,OK*09", CMD, 5, 2000, UART_DEBUG)){
+  return true;
+}
+
+int GNSS::waitForMTKAck(const char *body, unsigned int timeout)
+{
+  char line[NMEA_MAX_SENTENCE];
+  uint8_t len = 0;
+  int ack;
+  unsigned long timerStart = millis();
+
+  while((unsigned long)(millis() - timerStart) <= timeout * 1000UL){
+    if(!MC20_check_readable()){
+      continue;
+    }
+    char c = MC20_read_byte();
+
+    // Fixes streamed while we wait are not lost
+    feedNMEA(c);
+
+    if(c != '\r' && c != '\n'){
+      if(len < sizeof(line) - 1){
+        line[len++] = c;
+      }
+      continue;
+    }
+    line[len] = '\0';
+    len = 0;
+
+    if(NULL != strstr(line, "ERROR")){
+      return MTK_ACK_INVALID;
+    }
+    ack = parseMTKAck(line, body);
+    if(ack >= 0){
+      return ack;
+    }
+  }
+
+  return MTK_ACK_TIMEOUT;
+}
+
+int GNSS::parseMTKAck(const char *line, const char *body)
+{
+  const char *p = strchr(line, '$');
+  const char *star;
+  const char *comma;
+  int command;
+
+  // Echo of our own AT+QGNSSCMD, it carries body and a valid checksum too
+  if(0 == strncmp(line, "AT", 2)){
+    return -1;
+  }
+  if(NULL == p || NULL == (star = strchr(p, '*'))){
+    return -1;
+  }
+  if(strtoul(star + 1, NULL, 16) != getCheckSum(p + 1)){
+    return -1;
+  }
+  p++;
+
+  // $PMTK001,<cmd>,<flag>*hh
+  if(0 == strncmp(body, "PMTK", 4)){
+    if(0 != strncmp(p, "PMTK001,", 8)){
+      return -1;
+    }
+    // Some firmware acks PMTK353 as 262
+    command = atoi(p + 8);
+    if(command != atoi(body + 4) && !(command == 262 && atoi(body + 4) == 353)){
+      return -1;
+    }
+    comma = strchr(p + 8, ',');
+    return (NULL != comma && comma < star) ? atoi(comma + 1) : -1;
+  }
+
+  // $PQxxx,W,OK*hh / $PQxxx,W,ERROR*hh, the reply repeats body up to the second ','
+  comma = strchr(body, ',');
+  if(NULL == comma || NULL == (comma = strchr(comma + 1, ','))){
+    return -1;
+  }
+  if(0 != strncmp(p, body, comma - body + 1)){
+    return -1;
+  }
+  p += comma - body + 1;
+
+  return (0 == strncmp(p, "OK", 2)) ? MTK_ACK_SUCCESS : MTK_ACK_FAILED;
+}
+
+bool GNSS::feedNMEA(char c)
+{
+  if(nmeaTee != NULL){
+    nmeaTee(c);
+  }
+  if(!nmea.feed(c)){
     return false;
   }
+  updateCoordinate(nmea.getFix());
+  if(ttffPending && (fix.flags & FIX_VALID)){
+    recordTTFF();
+  }
+  if(fixCallback != NULL){
+    fixCallback(fix);
+  }
 
   return true;
 }
 
+void GNSS::feedNMEALine(const char *line)
+{
+  while(*line != '\0'){
+    feedNMEA(*line++);
+  }
+  feedNMEA('\n');
+}
+
+/* Read one non-empty line, false when timeout seconds since timerStart passed */
+bool GNSS::readLine(char *line, size_t size, unsigned long timerStart, unsigned int timeout)
+{
+  size_t len = 0;
+
+  while((unsigned long)(millis() - timerStart) <= timeout * 1000UL){
+    if(!MC20_check_readable()){
+      continue;
+    }
+    char c = MC20_read_byte();
+
+    if(c == '\r' || c == '\n'){
+      if(len > 0){
+        line[len] = '\0';
+        return true;
+      }
+      continue;
+    }
+    if(len < size - 1){
+      line[len++] = c;
+    }
+  }
+
+  return false;
+}
+
+bool GNSS::enable_EASY(void)
+{
+  static constexpr uint8_t checkSum = NMEA_checkSum("PMTK869,1,1");
+
+  return sendMTKCommand("PMTK869,1,1", checkSum);
+}
+
+
+bool GNSS::enable_GLP(int enable, int save)
+{
+  char str_buf[24];
+
+  sprintf(str_buf, "PQGLP,W,%d,%d", enable, save);
+  return sendMTKCommand(str_buf);
+}
+
 
 bool GNSS::eraseFlash_LOCUS(void)
 {
-  return MC20_check_with_cmd("AT+QGNSSCMD=0,\"$PMTK184,1*22\"\n\r", "+QGNSSCMD: $PMTK001,184,3*3D", CMD, 5, 2000, UART_DEBUG);
+  static constexpr uint8_t checkSum = NMEA_checkSum("PMTK184,1");
+
+  return sendMTKCommand("PMTK184,1", checkSum);
 }
 
 bool GNSS::stopLogger_LOCUS(int status)
 {
-  char str_buf[11];
-  char buf_w[64];
-  char checkSum;
+  char str_buf[16];
 
-  MC20_clean_buffer(str_buf, 11);
   sprintf(str_buf, "PMTK185,%d", status);
-  checkSum = getCheckSum(str_buf);
-
-  MC20_clean_buffer(buf_w, 64);
-  sprintf(buf_w, "AT+QGNSSCMD=0,\"$%s*%d\"", str_buf, checkSum);
+  return sendMTKCommand(str_buf);
+}
 
-  //
-  MC20_send_cmd(buf_w);
-  if(!MC20_check_with_cmd("\n\r", "+QGNSSCMD: $PMTK001,185,3*3C", CMD, 5, 2000)){
+bool GNSS::getQueryStatus_LOCUS(LOCUS_Status *status)
+{
+  static constexpr uint8_t checkSum = NMEA_checkSum("PMTK183");
+  char line[LOCUS_MAX_LINE];
+  LOCUS_Status reply;
+  bool gotStatus = false;
+  bool gotAck = false;
+  int ack;
+  unsigned long timerStart = millis();
+
+  if(!writeMTKCommand("PMTK183", checkSum)){
     return false;
   }
 
-  return true;
+  // $PMTKLOG,... and $PMTK001,183,3 in either order
+  while(!(gotStatus && gotAck) && readLine(line, sizeof(line), timerStart, DEFAULT_TIMEOUT)){
+    if(LOCUS_Decoder::parseStatus(line, &reply)){
+      gotStatus = true;
+      if(NULL != status){
+        *status = reply;
+      }
+      continue;
+    }
+    if(NULL != strstr(line, "ERROR")){
+      return false;
+    }
+    ack = parseMTKAck(line, "PMTK183");
+    if(ack >= 0){
+      if(ack != MTK_ACK_SUCCESS){
+        return false;
+      }
+      gotAck = true;
+      continue;
+    }
+    feedNMEALine(line);
+  }
+
+  return gotStatus;
 }
 
-bool GNSS::queryData_LOCUS(void)
+bool GNSS::queryData_LOCUS(GNSS_FixCallback callback, unsigned int timeout)
 {
-  return MC20_check_with_cmd("AT+QGNSSCMD=0,\"$PMTK622,1*29\"\n\r", "+QGNSSCMD: $PMTK001,184,3*3D", CMD, 5, 2000, true);
+  static constexpr uint8_t checkSum = NMEA_checkSum("PMTK622,1");
+  char line[LOCUS_MAX_LINE];
+  LOCUS_Status status;
+  int ack;
+  unsigned long timerStart;
+
+  // Records are laid out by the content mask they were logged with
+  if(!locus.reset(getQueryStatus_LOCUS(&status) ? status.content : LOCUS_CONTENT_BASIC)){
+    return false;
+  }
+  locus.setCallback(callback);
+
+  if(!writeMTKCommand("PMTK622,1", checkSum)){
+    return false;
+  }
+  timerStart = millis();
+
+  // $PMTKLOX,0,<n> / n x $PMTKLOX,1,... / $PMTKLOX,2 / $PMTK001,622,3
+  while(readLine(line, sizeof(line), timerStart, timeout)){
+    if(locus.feedLine(line)){
+      if(locus.finished){
+        // The $PMTK001,622 ack follows the last record, do not leave it to the next command
+        waitForMTKAck("PMTK622,1", 2);
+        return locus.complete();
+      }
+      continue;
+    }
+    if(NULL != strstr(line, "ERROR")){
+      return false;
+    }
+    ack = parseMTKAck(line, "PMTK622,1");
+    if(ack >= 0 && ack != MTK_ACK_SUCCESS){
+      return false;
+    }
+    if(ack < 0){
+      feedNMEALine(line);
+    }
+  }
+
+  return false;
 }
 
 bool GNSS::set1PPS(bool status)
 {
+  static constexpr uint8_t checkSumOn = NMEA_checkSum("PMTK255,1");
+  static constexpr uint8_t checkSumOff = NMEA_checkSum("PMTK255,0");
+
   if(status){
-    return MC20_check_with_cmd("AT+QGNSSCMD=0,\"$PMTK255,1*2D\"\n\r", "+QGNSSCMD: $PMTK001,255,3*32", CMD, 5, 2000, true);
+    return sendMTKCommand("PMTK255,1", checkSumOn);
   } else{
-    return MC20_check_with_cmd("AT+QGNSSCMD=0,\"$PMTK255,0*2C\"\n\r", "+QGNSSCMD: $PMTK001,255,3*32", CMD, 5, 2000, true);
+    return sendMTKCommand("PMTK255,0", checkSumOff);
   }
-
-  return true;
 }
 
-bool GNSS::setAlwaysLocateMode(int mode)
+bool GNSS::restart(int type)
 {
-  char str_buf[11];
-  char buf_w[64];
-  char checkSum;
-
-  MC20_clean_buffer(str_buf, 11);
-  sprintf(str_buf, "PMTK225,%d", mode);
-  checkSum = getCheckSum(str_buf);
-
-  MC20_clean_buffer(buf_w, 64);
-  sprintf(buf_w, "AT+QGNSSCMD=0,\"$%s*%d\"", str_buf, checkSum);
+  char str_buf[16];
 
-  //
-  MC20_send_cmd(buf_w);
-  if(!MC20_check_with_cmd("\n\r", "+QGNSSCMD: $PMTK001,225,3*35", CMD, 5, 2000, true)){
+  if(type < GNSS_HOT_START || type > GNSS_COLD_START){
+    return false;
+  }
+  sprintf(str_buf, "PMTK10%d", type);
+  if(!writeMTKCommand(str_buf, -1)){
     return false;
   }
+  return MC20_wait_for_resp("OK", CMD, 2, 2000, UART_DEBUG);
+}
 
-  return true;
+bool GNSS::setAlwaysLocateMode(int mode)
+{
+  char str_buf[16];
+
+  sprintf(str_buf, "PMTK225,%d", mode);
+  return sendMTKCommand(str_buf);
 }
 
 bool GNSS::select_searching_satellite(int gps, int beidou)
 {
-  char str_buf[20];
-  char buf_w[64];
-  char checkSum;
+  char str_buf[32];
 
-  MC20_clean_buffer(str_buf, 20);
   sprintf(str_buf, "PMTK353,%d,0,0,0,%d", gps, beidou);
-  checkSum = getCheckSum(str_buf);
+  return sendMTKCommand(str_buf);
+}
 
-  MC20_clean_buffer(buf_w, 64);
-  sprintf(buf_w, "AT+QGNSSCMD=0,\"$%s*%d\"", str_buf, checkSum);
+bool GNSS::setWorkMode(int mode)
+{
+  return setAlwaysLocateMode(mode);
+}
 
-  MC20_send_cmd(buf_w);
-  if(gps == 0 && beidou == 1){
-    if(!MC20_check_with_cmd("\n\r", "+QGNSSCMD: $PMTK001,353,3,0,0,0,0,1,48*08", CMD, 5, 2000)){
-      return false;
-    }
-  } else {
-    if(!MC20_check_with_cmd("\n\r", "+QGNSSCMD: $PMTK001,262,3,0*2A", CMD, 5, 2000)){
-      return false;
-    }
+bool GNSS::setStandbyMode(int mode)
+{
+  char str_buf[16];
+
+  sprintf(str_buf, "PMTK161,%d", mode);
+  // With a correct checksum a missing ack means the command was lost, retry once
+  if(sendMTKCommand(str_buf)){
+    return true;
   }
-  
+  return sendMTKCommand(str_buf);
+}
 
-  return true;
+bool GNSS::setNMEAOutput(int gll, int rmc, int vtg, int gga, int gsa, int gsv)
+{
+  char str_buf[48];
+
+  sprintf(str_buf, "PMTK314,%d,%d,%d,%d,%d,%d,0,0,0,0,0,0,0,0,0,0,0,0,0", gll, rmc, vtg, gga, gsa, gsv);
+  return sendMTKCommand(str_buf);
 }
 
-bool GNSS::setWorkMode(int mode)
+bool GNSS::setNMEASentences(uint8_t mask)
 {
-  char str_buf[11];
-  char buf_w[64];
-  char checkSum;
+  if(!setNMEAOutput((mask & NMEA_GLL) ? 1 : 0, (mask & NMEA_RMC) ? 1 : 0, (mask & NMEA_VTG) ? 1 : 0,
+                    (mask & NMEA_GGA) ? 1 : 0, (mask & NMEA_GSA) ? 1 : 0, (mask & NMEA_GSV) ? 1 : 0)){
+    return false;
+  }
 
-  MC20_clean_buffer(str_buf, 11);
-  sprintf(str_buf, "PMTK225,%d", mode);
-  checkSum = getCheckSum(str_buf);
+  // The parser can only wait for sentences that are still sent
+  if(mask & (NMEA_GGA | NMEA_RMC)){
+    nmea.fixSentences = mask & (NMEA_GGA | NMEA_RMC);
+  }
 
-  MC20_clean_buffer(buf_w, 64);
-  sprintf(buf_w, "AT+QGNSSCMD=0,\"$%s*%d\"", str_buf, checkSum);
+  return true;
+}
 
-  //
-  MC20_send_cmd(buf_w);
-  if(!MC20_check_with_cmd("\n\r", "+QGNSSCMD: $PMTK001,225,3*35", CMD, 5, 2000)){
+bool GNSS::resetNMEAOutput(void)
+{
+  static constexpr uint8_t checkSum = NMEA_checkSum("PMTK314,-1");
+
+  if(!sendMTKCommand("PMTK314,-1", checkSum)){
     return false;
   }
+  nmea.fixSentences = NMEA_GGA | NMEA_RMC;
 
   return true;
 }
 
-bool GNSS::setStandbyMode(int mode)
+uint32_t GNSS::measureBytesPerEpoch(int count, unsigned int timeout)
 {
-  char str_buf[11];
-  char buf_w[64];
-  char checkSum;
-  int errCount = 0;
+  unsigned long timerStart = millis();
+  uint32_t bytesStart;
+  uint32_t epochsStart;
+
+  // Start on an epoch boundary so a partial epoch is not counted
+  while(!readNMEAStream()){
+    if((unsigned long)(millis() - timerStart) > timeout * 1000UL){
+      return 0;
+    }
+  }
+  bytesStart = nmea.bytes;
+  epochsStart = nmea.epochs;
 
-  MC20_clean_buffer(str_buf, 11);
-  sprintf(str_buf, "PMTK161,%d", mode);
-  checkSum = getCheckSum(str_buf);
+  while((int)(nmea.epochs - epochsStart) < count){
+    readNMEAStream();
+    if((unsigned long)(millis() - timerStart) > timeout * 1000UL){
+      break;
+    }
+  }
+  if(nmea.epochs == epochsStart){
+    return 0;
+  }
 
-  MC20_clean_buffer(buf_w, 64);
-  sprintf(buf_w, "AT+QGNSSCMD=0,\"$%s*%d\"", str_buf, checkSum);
+  return (nmea.bytes - bytesStart) / (nmea.epochs - epochsStart);
+}
 
-  //
-  MC20_send_cmd(buf_w);
-  while(!MC20_check_with_cmd("\n\r", "+QGNSSCMD: $PMTK001,161,3*36", CMD, 5, 2000)){
-  // while(!MC20_check_with_cmd("\n\r", "OK", CMD, 5, 2000)){
-    errCount ++;
-    if(errCount > 10){
-      return false;
-    }
-    MC20_send_cmd(buf_w);
-    SerialUSB.println(__LINE__);
-    delay(1000);
+bool GNSS::setFixInterval(uint16_t interval)
+{
+  char str_buf[32];
+
+  if(interval < 100 || interval > 10000){
+    return false;
   }
 
+  sprintf(str_buf, "PMTK220,%u", interval);
+  if(!sendMTKCommand(str_buf)){
+    return false;
+  }
+
+  // Fix rate follows the output rate on most firmwares, set it explicitly anyway
+  sprintf(str_buf, "PMTK300,%u,0,0,0,0", interval);
+  sendMTKCommand(str_buf);
+
   return true;
 }
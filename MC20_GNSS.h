@@ -34,6 +34,64 @@
 
 #include "MC20_Common.h"
 #include "MC20_Arduino_Interface.h"
+#include "MC20_NMEA.h"
+#include "MC20_LOCUS.h"
+#include "MC20_FlashStore.h"
+
+/* Unsolicited NMEA output, sentences arrive as "+QGURC: $GNRMC,..." */
+#define GNSS_NMEA_STREAM_ON     "AT+QGURC=1\n\r"
+#define GNSS_NMEA_STREAM_OFF    "AT+QGURC=0\n\r"
+
+/* Longest AT+QGNSSCMD line sendMTKCommand() builds */
+#define GNSS_MTK_CMD_LEN        96
+
+/* Longest non-NMEA line readNMEAStream() hands to the URC handler */
+#define GNSS_URC_LINE           64
+
+/* A full LOCUS flash is ~1400 $PMTKLOX lines, seconds */
+#define LOCUS_DUMP_TIMEOUT      120
+
+/* PMTK001 flag values, MTK_ACK_TIMEOUT when nothing matching came back */
+enum MTK_ACK {
+    MTK_ACK_TIMEOUT = -1,
+    MTK_ACK_INVALID = 0,
+    MTK_ACK_UNSUPPORTED = 1,
+    MTK_ACK_FAILED = 2,
+    MTK_ACK_SUCCESS = 3
+};
+
+/* EPO data covers 6 hours, refreshed this long before it runs out. When a
+ * PDP context is up anyway the refresh is done earlier, it is cheap then.
+ * Seconds.
+ */
+#define EPO_VALIDITY                (6*3600UL)
+#define EPO_REFRESH_MARGIN          (30*60UL)
+#define EPO_OPPORTUNISTIC_MARGIN    (2*3600UL)
+
+/* Time to first fix after open_GNSS(), milliseconds */
+struct GNSS_TTFF {
+    uint16_t count;
+    uint32_t total;
+    uint32_t best;
+    uint32_t worst;
+};
+
+/* Last known position is saved at most this often, seconds, and only
+ * after moving this far, meters
+ */
+#define LKP_SAVE_INTERVAL       600
+#define LKP_SAVE_DISTANCE       100
+
+typedef void (*GNSS_FixCallback)(const GNSS_Fix &fix);
+typedef void (*GNSS_ByteCallback)(char c);
+typedef void (*GNSS_LineCallback)(const char *line);
+
+/* PMTK101 / 102 / 103 restart types */
+enum GNSS_START {
+    GNSS_HOT_START = 1,   // keep all aiding data
+    GNSS_WARM_START = 2,  // drop ephemeris
+    GNSS_COLD_START = 3   // drop time, position, almanac and ephemeris
+};
 
 enum GNSS_MDOE{
     GNSS_DEFAULT_MODE = 0, // Default quick start GNSS mode
@@ -49,10 +107,17 @@ public:
     double latitude;
     char str_longitude[16];
     char str_latitude[16];
-    double ref_longitude = 22.584322;
-    double ref_latitude = 113.966678;
+    double ref_latitude = 22.584322;    // reference location for EPO_RL_MODE
+    double ref_longitude = 113.966678;
     char North_or_South[2];
     char West_or_East[2];
+    GNSS_Fix fix;        // last fix read by readNMEAStream()
+    NMEA_Parser nmea;
+    LOCUS_Decoder locus; // state and counters of the last queryData_LOCUS()
+    GNSS_TTFF ttffFreshEPO = {0, 0, 0, 0};  // starts with valid EPO data
+    GNSS_TTFF ttffNoEPO = {0, 0, 0, 0};     // starts without
+    uint32_t lastTTFF = 0;   // ms, 0 until the first fix after open
+    GNSS_Fix lastPosition = {};  // last saved / loaded position, time 0 if none
     
     /**
      *
@@ -85,6 +150,7 @@ public:
     bool open_GNSS_EPO_LP_mode(void);   // Low power consumption mode with EPO
     
     /** Before open EPO and GNSS, write Reference-Location into flash, this can help search location faster
+     *  The saved position is used if there is one, else ref_latitude / ref_longitude
      *
      */
     bool open_GNSS_RL_mode(void);     // Reference-location mode
@@ -93,6 +159,44 @@ public:
      *
      */
     bool open_GNSS(void);
+
+    /** Keep the last good fix in flash, so every open in EPO_RL_MODE starts
+     *  from where the tracker was last seen. savePosition() writes it at most
+     *  every interval seconds and after moving distance meters.
+     *  @param  store     FlashStore on its own region, NULL to stop saving
+     */
+    void setPositionStore(FlashStore *store, uint32_t interval = LKP_SAVE_INTERVAL, uint32_t distance = LKP_SAVE_DISTANCE);
+
+    /** Load the saved position into lastPosition and ref_latitude / ref_longitude
+     *  @returns
+     *      true if a position was saved
+     *      false otherwise
+     */
+    bool loadLastPosition(void);
+
+    /** Save the current fix if it is due, call it from loop(). The flash
+     *  write stalls the CPU, so it is never done from readNMEAStream().
+     *  @returns
+     *      true if the fix was written
+     *      false if it was not due, or there is no valid fix or store
+     */
+    bool savePosition(void);
+
+    /** Save the current fix now, e.g. before sleeping
+     *  @returns
+     *      true on success
+     *      false if there is no valid fix or store
+     */
+    bool saveLastPosition(void);
+
+    /** Seed ref_latitude / ref_longitude from the serving cell (AT+QCELLLOC)
+     *  Needs network registration, takes a few seconds. Call it before
+     *  open_GNSS(EPO_RL_MODE) when loadLastPosition() finds nothing.
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool setReferenceFromCell(void);
     
     /**
      *
@@ -119,6 +223,33 @@ public:
      */
     bool triggerEPO(void);
 
+    /** EPO validity window and how long before expiry to refresh, seconds
+     */
+    void setEPOValidity(uint32_t validity, uint32_t margin = EPO_REFRESH_MARGIN);
+
+    /** Whether the EPO data loaded by refreshEPO() is still valid
+     *  @param  margin  seconds it has to stay valid for
+     */
+    bool isEPOValid(uint32_t margin = 0);
+
+    /** Download and inject EPO, unless the loaded data is still valid
+     *  for the refresh margin
+     *  @param  force  refresh anyway
+     *  @returns
+     *      true if EPO is valid or no time sync is available yet
+     *      false on error
+     */
+    bool refreshEPO(bool force = false);
+
+    /** Refresh EPO early if a PDP context is already active, so the
+     *  download does not cost an extra network attach. Call it after
+     *  GPRS work.
+     *  @returns
+     *      true if EPO was refreshed
+     *      false otherwise
+     */
+    bool refreshEPOIfConnected(void);
+
     /**
      * Convert double coordinate data to string
      */
@@ -135,29 +266,172 @@ public:
      */    
     bool dataFlowMode(void);
 
+    /** Turn the unsolicited NMEA output on or off.
+     *  Once on, the modem pushes every epoch by itself and readNMEAStream()
+     *  replaces polling with AT+QGNSSRD?.
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool enableNMEAStream(bool enable);
+
+    /** Register a function called with every fix completed by readNMEAStream()
+     *  @param  callback  NULL to remove
+     */
+    void setFixCallback(GNSS_FixCallback callback);
+
+    /** Register a function called with every raw byte that reaches the
+     *  NMEA parser, including the AT+QGNSSRD? response of getCoordinate(),
+     *  e.g. to capture the stream with NMEA_Recorder. Keep it short, it
+     *  runs once per byte.
+     *  @param  callback  NULL to remove
+     */
+    void setNMEATee(GNSS_ByteCallback callback);
+
+    /** Register a function called with every line readNMEAStream() reads
+     *  that is not NMEA, i.e. URCs of the rest of the modem sharing the
+     *  UART. Pass them on to GPRS::handleLine() when a connection is open
+     *  next to the NMEA stream, or "+QIRDI" and "CLOSED" are lost.
+     *  @param  callback  NULL to remove
+     */
+    void setURCHandler(GNSS_LineCallback callback);
+
+    /** Parse the NMEA bytes waiting in the serial buffer, never blocks.
+     *  Call it from loop() at least every 100 ms at 115200 baud.
+     *  @returns
+     *      true if a new fix was completed
+     *      false otherwise
+     */
+    bool readNMEAStream(void);
+
     /* 
         MTK and PQ commands 
     */
-    uint8_t getCheckSum(char *string);
+
+    /** XOR checksum of a sentence body, a leading '$' and a trailing
+     *  "*hh" are skipped. Use NMEA_checkSum() for constant strings.
+     */
+    uint8_t getCheckSum(const char *string);
+
+    /** Send a PMTK or PQ sentence through AT+QGNSSCMD and wait for its ack.
+     *  $PMTK001 replies are parsed for the matching command and flag,
+     *  PQ replies for OK.
+     *  @param  body      sentence without '$' and checksum, "PMTK220,1000"
+     *  @param  checkSum  precomputed with NMEA_checkSum(), -1 to compute here
+     *  @param  timeout   seconds to wait for the ack
+     *  @returns
+     *      true if the GNSS acknowledged success
+     *      false on error, invalid / unsupported command or timeout
+     */
+    bool sendMTKCommand(const char *body, int checkSum = -1, unsigned int timeout = DEFAULT_TIMEOUT);
+
     bool enable_EASY(void);
     bool enable_GLP(int enable, int save);
     bool set_DGPS_Mode();
 
-    bool getQueryStatus_LOCUS(void);
+    /** Read the LOCUS logger status (PMTK183)
+     *  @param  status  filled from the $PMTKLOG reply, may be NULL
+     *  @returns
+     *      true on success
+     *      false on error or timeout
+     */
+    bool getQueryStatus_LOCUS(LOCUS_Status *status = NULL);
     bool eraseFlash_LOCUS(void);
     bool stopLogger_LOCUS(int status);
-    bool queryData_LOCUS(void);
+
+    /** Dump the LOCUS flash (PMTK622,1) and decode it.
+     *  The GNSS logs on its own while the MCU and GSM sleep, the records
+     *  come back here as fixes in the order they were logged.
+     *  @param  callback  called for every record that passes its checksum
+     *  @param  timeout   seconds for the whole dump
+     *  @returns
+     *      true if every packet arrived intact, see locus for counters
+     *      false otherwise
+     */
+    bool queryData_LOCUS(GNSS_FixCallback callback = NULL, unsigned int timeout = LOCUS_DUMP_TIMEOUT);
     bool setPeriodicMode();
     bool set1PPS(bool status);
+
+    /** Restart the receiver as a hot, warm or cold start
+     *  There is no PMTK001 ack, the receiver reboots.
+     *  @param  type  GNSS_START
+     *  @returns
+     *      true if the command was accepted
+     *      false on error
+     */
+    bool restart(int type);
     bool setAlwaysLocateMode(int mode);
 
     bool select_searching_satellite(int gps, int beidou);
 
     bool setWorkMode(int mode);
     bool setStandbyMode(int mode);
+
+    /** Set NMEA output rates (PMTK314), one per sentence type
+     *  @param  rate  0 disables the sentence, n outputs it once every n fixes
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool setNMEAOutput(int gll, int rmc, int vtg, int gga, int gsa, int gsv);
+
+    /** Output only the sentence types in mask, e.g. NMEA_RMC | NMEA_GGA
+     *  Also tells the stream parser which sentences make a complete fix.
+     */
+    bool setNMEASentences(uint8_t mask);
+
+    /** Restore the factory NMEA output rates (PMTK314,-1)
+     */
+    bool resetNMEAOutput(void);
+
+    /** Measure the UART bytes the NMEA stream costs per epoch.
+     *  Reads the stream (and keeps delivering fixes) until count epochs passed.
+     *  @param  count    epochs to average over
+     *  @param  timeout  seconds
+     *  @returns
+     *      average bytes per epoch, 0 if no epoch was seen
+     */
+    uint32_t measureBytesPerEpoch(int count, unsigned int timeout = DEFAULT_TIMEOUT*2);
+
+    /** Set position fix and NMEA output interval (PMTK220, PMTK300)
+     *  @param  interval  milliseconds, 100 - 10000
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool setFixInterval(uint16_t interval);
     /* 
         End of MTK and PQ commands
     */
+
+private:
+    void updateCoordinate(const GNSS_Fix &newFix);
+    bool feedNMEA(char c);
+    void feedNMEALine(const char *line);
+    bool readLine(char *line, size_t size, unsigned long timerStart, unsigned int timeout);
+    void startTTFF(void);
+    void recordTTFF(void);
+    bool writeMTKCommand(const char *body, int checkSum);
+    int  waitForMTKAck(const char *body, unsigned int timeout);
+    int  parseMTKAck(const char *line, const char *body);
+
+    GNSS_FixCallback fixCallback = NULL;
+    GNSS_ByteCallback nmeaTee = NULL;
+    GNSS_LineCallback urcHandler = NULL;
+    char urcLine[GNSS_URC_LINE];
+    uint8_t urcLength = 0;
+
+    uint32_t epoValidity = EPO_VALIDITY;
+    uint32_t epoMargin = EPO_REFRESH_MARGIN;
+    bool epoLoaded = false;
+    unsigned long epoLoadedAt = 0;     // millis() of the last refresh
+    bool ttffPending = false;
+    bool ttffWithEPO = false;
+    unsigned long openedAt = 0;        // millis() of open_GNSS()
+
+    FlashStore *positionStore = NULL;
+    uint32_t saveInterval = LKP_SAVE_INTERVAL;
+    uint32_t saveDistance = LKP_SAVE_DISTANCE;
 };
 
 #endif
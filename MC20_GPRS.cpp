@@ -217,42 +217,504 @@ int GPRS::networkCheck(void)
     return 0;
 }
 
-bool GPRS::connectTCP(const char *ip, int port)
+bool GPRS::connectTCP(const char *ip, int port, uint8_t attempts)
+{
+    return connectIP("TCP", ip, port, attempts);
+}
+
+bool GPRS::connectUDP(const char *ip, int port)
+{
+    return connectIP("UDP", ip, port, 1);
+}
+
+bool GPRS::connectIP(const char *protocol, const char *ip, int port, uint8_t attempts)
 {
     uint8_t errCount = 0;
-    char cipstart[50];
+    char cipstart[64];
 
-    sprintf(cipstart, "AT+QIOPEN=\"TCP\",\"%s\",%d\r\n", ip, port);
+    snprintf(cipstart, sizeof(cipstart), "AT+QIOPEN=\"%s\",\"%s\",%d\r\n", protocol, ip, port);
+    resetReceive(0);
     while(!MC20_check_with_cmd(cipstart, "CONNECT OK", CMD, 2*DEFAULT_TIMEOUT)) {// connect tcp
         ERROR("ERROR:QIOPEN");
-        if(errCount > 3){
+        if(++errCount >= attempts){
             return false;
         }
-        errCount++;
     }
+    tcpConnected = true;
 
     return true;
 }
+
+bool GPRS::isTCPConnected(void)
+{
+    MC20_flush_serial();
+    // STATE: CONNECT OK, anything else (IP CLOSE, PDP DEACT, ...) is down
+    tcpConnected = MC20_check_with_cmd("AT+QISTATE\r\n", "STATE: CONNECT OK", CMD, 2);
+
+    return tcpConnected;
+}
+
+void GPRS::poll(void)
+{
+    while(MC20_check_readable()){
+        char c = MC20_read_byte();
+
+        if(c != '\r' && c != '\n'){
+            if(urcLength < sizeof(urcLine) - 1){
+                urcLine[urcLength++] = c;
+            }
+            continue;
+        }
+        if(urcLength > 0){
+            urcLine[urcLength] = '\0';
+            urcLength = 0;
+            handleURC(urcLine);
+        }
+    }
+
+    // Pull announced data while there is room for it
+    for(uint8_t i = 0; i < GPRS_MAX_SOCKETS; i++){
+        if(rx[i].pending && (NULL != dataCallback || rx[i].count < GPRS_RX_BUFFER)){
+            fetch(i);
+        }
+    }
+}
+
+void GPRS::handleLine(const char *line)
+{
+    handleURC(line);
+}
+
+void GPRS::handleURC(const char *line)
+{
+    long socket, length;
+    char *p;
+
+    if(0 == strcmp(line, "CLOSED")){
+        tcpConnected = false;
+    } else if(0 == strncmp(line, "+PDP DEACT", 10)){
+        tcpConnected = false;
+        for(uint8_t i = 0; i < GPRS_MAX_SOCKETS; i++){
+            sockets[i] = CLOSED;
+        }
+    } else if(0 == strncmp(line, "+QIRDI: ", 8)){
+        // +QIRDI: <context>,<role>,<socket>
+        const char *last = strrchr(line, ',');
+        socket = (NULL != last) ? strtol(last + 1, NULL, 10) : 0;
+        if(socket >= 0 && socket < GPRS_MAX_SOCKETS){
+            rx[socket].pending = true;
+        }
+    } else if(0 == strncmp(line, "+RECEIVE: ", 10)){
+        // +RECEIVE: <index>, <length>, the data follows the line
+        socket = strtol(line + 10, &p, 10);
+        length = (*p == ',') ? strtol(p + 1, NULL, 10) : 0;
+        receiveData(socket, length);
+    } else if(line[0] >= '0' && line[0] <= '9' && 0 == strcmp(line + 1, ", CLOSED")){
+        socket = line[0] - '0';
+        if(socket < GPRS_MAX_SOCKETS){
+            sockets[socket] = CLOSED;
+        }
+    }
+}
+
 bool GPRS::sendTCPData(char *data)
+{
+    return send((const uint8_t *)data, strlen(data));
+}
+
+bool GPRS::send(const uint8_t *data, size_t length, int socket)
+{
+    GPRS_Buffer buffer = {data, length};
+
+    return send(&buffer, 1, socket);
+}
+
+bool GPRS::send(const GPRS_Buffer *buffers, uint8_t count, int socket)
 {
     char cmd[32];
-    int len = strlen(data); 
-    snprintf(cmd,sizeof(cmd),"AT+QISEND=%d\r\n",len);
-    if(!MC20_check_with_cmd(cmd,">", CMD, 2*DEFAULT_TIMEOUT)) {
-        ERROR("ERROR:QISEND");
+    size_t total = 0;
+    size_t offset = 0;      // into buffers[part]
+    uint8_t part = 0;
+
+    if(socket >= 0 && !isSocketOpen(socket)){
         return false;
     }
-        
-    if(!MC20_check_with_cmd(data,"SEND OK", DATA, 2*DEFAULT_TIMEOUT)) {
-        ERROR("ERROR:SendTCPData");
-        return false;
-    }   
+    for(uint8_t i = 0; i < count; i++){
+        total += buffers[i].length;
+    }
+
+    sentBytes = 0;
+    writtenBytes = 0;
+    poll();
+    while(total > 0){
+        size_t chunk = total < GPRS_MAX_SEND ? total : GPRS_MAX_SEND;
+        size_t piece = chunk;
+
+        if(socket >= 0){
+            snprintf(cmd, sizeof(cmd), "AT+QISEND=%d,%u\r\n", socket, (unsigned int)chunk);
+        } else {
+            snprintf(cmd, sizeof(cmd), "AT+QISEND=%u\r\n", (unsigned int)chunk);
+        }
+        if(!MC20_check_with_cmd(cmd, ">", CMD, 2*DEFAULT_TIMEOUT)) {
+            ERROR("ERROR:QISEND");
+            return false;
+        }
+
+        // Straight from the caller's buffers, crossing into the next one as needed
+        total -= chunk;
+        while(chunk > 0){
+            size_t n = buffers[part].length - offset;
+            if(n > chunk){
+                n = chunk;
+            }
+            MC20_send_data(buffers[part].data + offset, n);
+            chunk -= n;
+            offset += n;
+            if(offset == buffers[part].length){
+                part++;
+                offset = 0;
+            }
+        }
+        writtenBytes += piece;
+
+        if(!MC20_wait_for_resp("SEND OK", DATA, 2*DEFAULT_TIMEOUT)) {
+            ERROR("ERROR:SendTCPData");
+            return false;
+        }
+        sentBytes += piece;
+    }
+    return true;
+}
+
+long GPRS::unackedBytes(int socket)
+{
+    char cmd[24];
+    long sent, acked, unacked;
+
+    poll();
+    // +QISACK: <sent>,<acked>,<nAcked>
+    if(socket >= 0){
+        sprintf(cmd, "AT+QISACK=%d\r\n", socket);
+    } else {
+        sprintf(cmd, "AT+QISACK\r\n");
+    }
+    MC20_send_cmd(cmd);
+    if(!MC20_wait_for_resp("+QISACK: ", DATA, DEFAULT_TIMEOUT) ||
+       !MC20_read_number(&sent) || !MC20_read_number(&acked) || !MC20_read_number(&unacked)){
+        return -1;
+    }
+    MC20_wait_for_resp("OK", CMD, 1);
+
+    return unacked;
+}
+
+bool GPRS::waitAcked(int socket, unsigned int timeout)
+{
+    unsigned long timerStart = millis();
+    long unacked;
+
+    while((unacked = unackedBytes(socket)) != 0){
+        if(unacked < 0 || (unsigned long)(millis() - timerStart) > timeout * 1000UL){
+            return false;
+        }
+        delay(500);
+    }
     return true;
 }
 
 bool GPRS::closeTCP(void)
 {
+    char line[GPRS_URC_LINE];
+    unsigned long timerStart = millis();
+
     MC20_send_cmd("AT+QICLOSE\r\n");
+    tcpConnected = false;
+    resetReceive(0);
+    // Wait for the result so an AT+QIOPEN right after does not race the close
+    while(readLine(line, sizeof(line), timerStart, DEFAULT_TIMEOUT)){
+        if(0 == strcmp(line, "CLOSE OK")){
+            return true;
+        }
+        if(NULL != strstr(line, "ERROR")){
+            return false;
+        }
+        handleURC(line);
+    }
+    return false;
+}
+
+bool GPRS::readLine(char *line, size_t size, unsigned long timerStart, unsigned int timeout)
+{
+    size_t len = 0;
+
+    while((unsigned long)(millis() - timerStart) <= timeout * 1000UL){
+        if(!MC20_check_readable()){
+            continue;
+        }
+        char c = MC20_read_byte();
+
+        if(c == '\r' || c == '\n'){
+            if(len > 0){
+                line[len] = '\0';
+                return true;
+            }
+            continue;
+        }
+        if(len < size - 1){
+            line[len++] = c;
+        }
+    }
+
+    return false;
+}
+
+void GPRS::receiveData(uint8_t socket, long length)
+{
+    uint8_t data[GPRS_RECV_CHUNK];
+    int n;
+
+    // The line ended on '\r', its '\n' comes first
+    if(MC20_read_data(data, 1, 1) == 1 && data[0] != '\n'){
+        length--;
+        deliver(socket, data, 1);
+    }
+    while(length > 0){
+        n = MC20_read_data(data, length < GPRS_RECV_CHUNK ? length : GPRS_RECV_CHUNK, 1);
+        if(n == 0){
+            break;
+        }
+        length -= n;
+        deliver(socket, data, n);
+    }
+}
+
+/* To the data callback if there is one, otherwise into the receive buffer */
+void GPRS::deliver(uint8_t socket, const uint8_t *data, size_t length)
+{
+    GPRS_RxBuffer *buffer;
+
+    if(socket >= GPRS_MAX_SOCKETS){
+        return;
+    }
+    if(NULL != dataCallback){
+        dataCallback(socket, data, length);
+        return;
+    }
+    buffer = &rx[socket];
+    for(size_t i = 0; i < length; i++){
+        if(buffer->count == GPRS_RX_BUFFER){
+            rxDropped += length - i;
+            break;
+        }
+        buffer->data[(buffer->head + buffer->count) % GPRS_RX_BUFFER] = data[i];
+        buffer->count++;
+    }
+}
+
+/* AT+QIRD for as much as the receive buffer can take */
+bool GPRS::fetch(uint8_t socket)
+{
+    char cmd[32];
+    char line[GPRS_URC_LINE];
+    uint8_t data[GPRS_RECV_CHUNK];
+    long request, size;
+    char *p = NULL;
+    int n;
+
+    request = (NULL != dataCallback) ? GPRS_RX_BUFFER : GPRS_RX_BUFFER - rx[socket].count;
+    sprintf(cmd, "AT+QIRD=0,1,%d,%ld\r\n", socket, request);
+    MC20_send_cmd(cmd);
+
+    // +QIRD: <ip>:<port>,<TCP|UDP>,<length>\r\n<data>\r\nOK, or only OK when empty
+    unsigned long timerStart = millis();
+    while(readLine(line, sizeof(line), timerStart, GPRS_FETCH_TIMEOUT)){
+        if(0 == strcmp(line, "OK") || NULL != strstr(line, "ERROR")){
+            rx[socket].pending = false;
+            return true;
+        }
+        if(0 == strncmp(line, "+QIRD: ", 7) && NULL != (p = strrchr(line, ','))){
+            break;
+        }
+        // A URC that came in between
+        handleURC(line);
+    }
+    if(NULL == p){
+        // No answer, still pending: the next poll() asks again
+        return false;
+    }
+
+    size = strtol(p + 1, NULL, 10);
+    // Less than asked for: the modem has nothing left
+    rx[socket].pending = (size == request);
+    MC20_read_data(data, 1, 1);    // '\n' of the header line
+    while(size > 0){
+        n = MC20_read_data(data, size < GPRS_RECV_CHUNK ? size : GPRS_RECV_CHUNK, 1);
+        if(n == 0){
+            return false;
+        }
+        size -= n;
+        deliver(socket, data, n);
+    }
+    return MC20_wait_for_resp("OK", CMD, 1);
+}
+
+void GPRS::resetReceive(uint8_t socket)
+{
+    rx[socket].head = 0;
+    rx[socket].count = 0;
+    rx[socket].pending = false;
+}
+
+bool GPRS::enableReceiveBuffer(bool enable)
+{
+    if(!MC20_check_with_cmd(enable ? "AT+QINDI=1\r\n" : "AT+QINDI=0\r\n", "OK", CMD, 2)){
+        return false;
+    }
+    indicate = enable;
+
+    return true;
+}
+
+int GPRS::available(int socket)
+{
+    if(socket < 0){
+        socket = 0;
+    }
+    if(socket >= GPRS_MAX_SOCKETS){
+        return 0;
+    }
+    poll();
+
+    return rx[socket].count;
+}
+
+int GPRS::read(uint8_t *buffer, size_t length, int socket)
+{
+    GPRS_RxBuffer *rxBuffer;
+    size_t n = 0;
+
+    if(socket < 0){
+        socket = 0;
+    }
+    if(socket >= GPRS_MAX_SOCKETS){
+        return 0;
+    }
+    rxBuffer = &rx[socket];
+    while(n < length && rxBuffer->count > 0){
+        buffer[n++] = rxBuffer->data[rxBuffer->head];
+        rxBuffer->head = (rxBuffer->head + 1) % GPRS_RX_BUFFER;
+        rxBuffer->count--;
+    }
+    return n;
+}
+
+int GPRS::read(int socket)
+{
+    uint8_t c;
+
+    return read(&c, 1, socket) == 1 ? c : -1;
+}
+
+void GPRS::setDataCallback(GPRS_DataCallback callback)
+{
+    dataCallback = callback;
+}
+
+bool GPRS::enableMux(bool enable)
+{
+    if(!MC20_check_with_cmd(enable ? "AT+QIMUX=1\r\n" : "AT+QIMUX=0\r\n", "OK", CMD, 2)){
+        return false;
+    }
+    mux = enable;
+
     return true;
 }
 
+int GPRS::openSocket(Protocol protocol, const char *host, int port)
+{
+    char cmd[96];
+    char resp[16];
+    uint8_t socket;
+
+    for(socket = 0; socket < GPRS_MAX_SOCKETS && sockets[socket] != CLOSED; socket++);
+    if(!mux || socket == GPRS_MAX_SOCKETS || protocol == CLOSED){
+        return -1;
+    }
+
+    poll();
+    resetReceive(socket);
+    snprintf(cmd, sizeof(cmd), "AT+QIOPEN=%d,\"%s\",\"%s\",%d\r\n",
+             socket, protocol == UDP ? "UDP" : "TCP", host, port);
+    sprintf(resp, "%d, CONNECT OK", socket);
+    if(!MC20_check_with_cmd(cmd, resp, CMD, 2*DEFAULT_TIMEOUT)){
+        ERROR("ERROR:QIOPEN");
+        // Do not leave a half open socket on the index
+        closeSocket(socket);
+        return -1;
+    }
+    sockets[socket] = protocol;
+
+    return socket;
+}
+
+bool GPRS::sendSocket(uint8_t socket, const char *data)
+{
+    return send((const uint8_t *)data, strlen(data), socket);
+}
+
+bool GPRS::closeSocket(uint8_t socket)
+{
+    char cmd[24];
+    char resp[16];
+
+    if(socket >= GPRS_MAX_SOCKETS){
+        return false;
+    }
+    poll();
+    sprintf(cmd, "AT+QICLOSE=%d\r\n", socket);
+    sprintf(resp, "%d, CLOSE OK", socket);
+    sockets[socket] = CLOSED;
+    resetReceive(socket);
+
+    return MC20_check_with_cmd(cmd, resp, CMD, DEFAULT_TIMEOUT);
+}
+
+bool GPRS::isSocketConnected(uint8_t socket)
+{
+    char line[96];
+    char prefix[16];
+    bool seen = false;
+    bool connected = false;
+    unsigned long timerStart;
+
+    if(socket >= GPRS_MAX_SOCKETS){
+        return false;
+    }
+    poll();
+    // +QISTATE: <index>,"TCP","<ip>",<port>,"CONNECTED", one line per socket.
+    // Read line by line, the whole answer is longer than any buffer we keep.
+    sprintf(prefix, "+QISTATE: %d,", socket);
+    MC20_send_cmd("AT+QISTATE\r\n");
+    timerStart = millis();
+    while(readLine(line, sizeof(line), timerStart, 2)){
+        if(0 == strncmp(line, "+QISTATE: ", 10)){
+            if(0 == strncmp(line, prefix, strlen(prefix))){
+                seen = true;
+                connected = (NULL != strstr(line, "\"CONNECTED\""));
+            }
+            if(atoi(line + 10) == GPRS_MAX_SOCKETS - 1){
+                break;
+            }
+        } else if(NULL != strstr(line, "ERROR")){
+            break;
+        } else {
+            handleURC(line);
+        }
+    }
+    // Only a state actually reported frees the index
+    if(seen && !connected){
+        sockets[socket] = CLOSED;
+    }
+
+    return connected;
+}
@@ -35,6 +35,35 @@
 #include "MC20_Common.h"
 #include "MC20_Arduino_Interface.h"
 
+#define GPRS_URC_LINE   64      // longest unsolicited line kept by poll()
+#define GPRS_MAX_SOCKETS 6      // socket indexes 0 - 5 with AT+QIMUX=1
+#define GPRS_RECV_CHUNK 64      // bytes handed to the data callback at a time
+#define GPRS_MAX_SEND   1460    // most bytes per AT+QISEND
+#define GPRS_FETCH_TIMEOUT 1    // s, longest wait for the answer to AT+QIRD
+
+#ifndef GPRS_RX_BUFFER
+#define GPRS_RX_BUFFER  256     // receive ring per socket, 6 sockets take 1.5 KB
+#endif
+
+/* Received data of one socket waiting for read() */
+struct GPRS_RxBuffer {
+    uint8_t data[GPRS_RX_BUFFER];
+    uint16_t head;          // oldest byte
+    uint16_t count;
+    bool pending;           // "+QIRDI" seen, the modem holds more data
+};
+
+/* One piece of a scatter-gather send */
+struct GPRS_Buffer {
+    const uint8_t *data;
+    size_t length;
+};
+
+/** Called by poll() with data received on a socket, in pieces of at most
+ *  GPRS_RECV_CHUNK bytes
+ */
+typedef void (*GPRS_DataCallback)(uint8_t socket, const uint8_t *data, size_t length);
+
 
 // enum Protocol {
 //     CLOSED = 0,
@@ -47,6 +76,13 @@ class GPRS : public GPSTracker
 public:
     uint32_t _ip;
     char ip_string[32];
+    bool tcpConnected = false;  // single connection up, TCP or UDP, cleared by closeTCP() and "CLOSED"
+    bool mux = false;           // AT+QIMUX=1, use the socket functions
+    Protocol sockets[GPRS_MAX_SOCKETS] = {CLOSED, CLOSED, CLOSED, CLOSED, CLOSED, CLOSED};
+    uint32_t rxDropped = 0;     // pushed bytes lost to a full receive buffer
+    size_t sentBytes = 0;       // bytes of the last send() that got SEND OK
+    size_t writtenBytes = 0;    // bytes of the last send() given to a ">" prompt,
+                                // they may have gone out without SEND OK
 
     /** Create GPRS instance
      *  @param number default phone number during mobile communication
@@ -90,11 +126,41 @@ public:
     /** build TCP connect
      *  @param  ip  ip address which will connect to
      *  @param  port    TCP server' port number
+     *  @param  attempts    AT+QIOPEN tries, 10 s each
      *  @returns
      *      0 on success
      *      -1 on error
      */
-    bool connectTCP(const char* ip, int port);
+    bool connectTCP(const char* ip, int port, uint8_t attempts = 5);
+
+    /** Open the single connection as UDP. There is no handshake, the modem
+     *  only binds the remote address, so this is cheap to do on every wake.
+     *  send() then sends one datagram per AT+QISEND, close it with closeTCP().
+     *  @returns
+     *      true on CONNECT OK
+     *      false on error
+     */
+    bool connectUDP(const char* ip, int port);
+
+    /** Ask the modem whether the TCP connection is up (AT+QISTATE)
+     *  @returns
+     *      true if the state is CONNECT OK
+     *      false otherwise
+     */
+    bool isTCPConnected(void);
+
+    /** Handle unsolicited result codes waiting in the serial buffer. Only
+     *  blocks to pull data announced by "+QIRDI" (enableReceiveBuffer()),
+     *  for the AT+QIRD answer, GPRS_FETCH_TIMEOUT at most per socket.
+     *  Call it from loop() while a connection is open.
+     */
+    void poll(void);
+
+    /** Handle one line read from the UART by someone else, e.g. by
+     *  GNSS::readNMEAStream() through GNSS::setURCHandler(). Data announced
+     *  by it is pulled by the next poll().
+     */
+    void handleLine(const char *line);
 
     /** send data to TCP server
      *  @param  data    data that will be send to TCP server
@@ -104,12 +170,133 @@ public:
      */
     bool sendTCPData(char* data);
 
-    /** close TCP connection
+    /** Send binary data, split into AT+QISEND pieces of GPRS_MAX_SEND bytes
+     *  and streamed from the caller's buffer without a copy. Only SEND OK
+     *  (accepted by the modem) is waited for between pieces, use
+     *  waitAcked() to know the server has it all.
+     *  @param  socket  socket index with enableMux(), -1 for the single connection
+     *  @returns
+     *      true if every piece got SEND OK
+     *      false on error
+     */
+    bool send(const uint8_t *data, size_t length, int socket = -1);
+
+    /** Send several buffers as one stream, e.g. header, payload and checksum,
+     *  without gathering them in RAM first. Pieces are cut across buffer
+     *  boundaries so each AT+QISEND is full.
+     */
+    bool send(const GPRS_Buffer *buffers, uint8_t count, int socket = -1);
+
+    /** Bytes sent but not acknowledged by the server yet (AT+QISACK)
+     *  @returns
+     *      bytes, -1 on error
+     */
+    long unackedBytes(int socket = -1);
+
+    /** Wait until the server acknowledged everything sent
+     *  @param  timeout  seconds
+     *  @returns
+     *      true when all data is acknowledged
+     *      false on timeout or error
+     */
+    bool waitAcked(int socket = -1, unsigned int timeout = 2*DEFAULT_TIMEOUT);
+
+    /** close TCP connection, waits for CLOSE OK
      *  @returns
      *      0 on success
      *      -1 on error
      */
     bool closeTCP(void);
+
+    /*
+        Multiple sockets, AT+QIMUX=1
+    */
+
+    /** Switch between one implicit connection and indexed sockets.
+     *  Call after init() and before join(), the modem only accepts it
+     *  while no PDP context is active.
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool enableMux(bool enable);
+
+    /** Open a socket on the first free index
+     *  @param  protocol  TCP or UDP
+     *  @returns
+     *      socket index 0 - 5, -1 on error
+     */
+    int openSocket(Protocol protocol, const char *host, int port);
+
+    /** Send a string on a socket
+     *  @returns
+     *      true on SEND OK
+     *      false on error
+     */
+    bool sendSocket(uint8_t socket, const char *data);
+
+    bool closeSocket(uint8_t socket);
+
+    bool isSocketOpen(uint8_t socket) const { return socket < GPRS_MAX_SOCKETS && sockets[socket] != CLOSED; }
+
+    /** Ask the modem whether a socket is connected (AT+QISTATE)
+     */
+    bool isSocketConnected(uint8_t socket);
+
+    /** Register a function called by poll() with data received on any socket,
+     *  the socket index tells the streams apart
+     *  @param  callback  NULL to drop received data
+     */
+    void setDataCallback(GPRS_DataCallback callback);
+
+    /*
+        Receive path
+    */
+
+    /** Have the modem hold received data and announce it with "+QIRDI"
+     *  (AT+QINDI=1) instead of pushing it into the AT stream. poll() then
+     *  pulls it with AT+QIRD, no more than the receive buffer can take,
+     *  the rest waits in the modem. Call before opening connections.
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool enableReceiveBuffer(bool enable);
+
+    /** Bytes received and not read yet, polls first. The buffer is emptied
+     *  when the connection on that index is opened or closed.
+     *  @param  socket  socket index with enableMux(), -1 for the single connection
+     */
+    int available(int socket = -1);
+
+    /** Read received bytes, never blocks
+     *  @returns
+     *      bytes copied to buffer, 0 if none
+     */
+    int read(uint8_t *buffer, size_t length, int socket = -1);
+
+    /** Read one received byte
+     *  @returns
+     *      the byte, -1 if none
+     */
+    int read(int socket = -1);
+
+private:
+    bool connectIP(const char *protocol, const char *ip, int port, uint8_t attempts);
+    bool readLine(char *line, size_t size, unsigned long timerStart, unsigned int timeout);
+    void handleURC(const char *line);
+    void receiveData(uint8_t socket, long length);
+    void deliver(uint8_t socket, const uint8_t *data, size_t length);
+    bool fetch(uint8_t socket);
+    void resetReceive(uint8_t socket);
+
+    GPRS_RxBuffer rx[GPRS_MAX_SOCKETS] = {};
+    bool indicate = false;      // AT+QINDI=1
+
+    GPRS_DataCallback dataCallback = NULL;
+
+    char urcLine[GPRS_URC_LINE];
+    uint8_t urcLength = 0;
 };
 
 #endif
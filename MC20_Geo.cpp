@@ -0,0 +1,68 @@
+/*
+ * MC20_Geo.cpp
+ * A library for SeeedStudio GPS Tracker local projection helpers
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include "MC20_Geo.h"
+
+uint32_t Geo_isqrt64(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while(bit > value){
+        bit >>= 2;
+    }
+    while(bit != 0){
+        if(value >= result + bit){
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+int32_t Geo_lonScaleQ16(int32_t latitude)
+{
+    int32_t scale = (int32_t)(LAT_SCALE_Q16 * cos(latitude * (M_PI / 1800000000.0)));
+
+    return scale < 1 ? 1 : scale;
+}
+
+void Geo_updateLonScale(int32_t latitude, int32_t *lonScale, int32_t *scaleLatitude)
+{
+    if(*lonScale == 0 || latitude - *scaleLatitude > LON_SCALE_REFRESH || *scaleLatitude - latitude > LON_SCALE_REFRESH){
+        *lonScale = Geo_lonScaleQ16(latitude);
+        *scaleLatitude = latitude;
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * MC20_Geo.h
+ * A library for SeeedStudio GPS Tracker local projection helpers
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_GEO_H__
+#define __MC20_GEO_H__
+
+#include <stdint.h>
+
+/* 1e-7 degree of latitude in cm, Q16 */
+#define LAT_SCALE_Q16       72873L      // 1.11195 * 65536
+
+/* A cached longitude scale is refreshed when latitude moves more than this,
+ * 0.1 degree
+ */
+#define LON_SCALE_REFRESH   1000000L
+
+/** Integer square root, floor(sqrt(value)) */
+uint32_t Geo_isqrt64(uint64_t value);
+
+/** cm per 1e-7 degree of longitude at a latitude, Q16, at least 1
+ *  @param  latitude  degrees * 1e7
+ */
+int32_t Geo_lonScaleQ16(int32_t latitude);
+
+/** Keep a cached longitude scale in step with the latitude, the cosine is
+ *  only computed again after a move of LON_SCALE_REFRESH
+ *  @param  lonScale       cached scale, 0 if none yet
+ *  @param  scaleLatitude  latitude the scale was computed for
+ */
+void Geo_updateLonScale(int32_t latitude, int32_t *lonScale, int32_t *scaleLatitude);
+
+#endif
@@ -0,0 +1,372 @@
+/*
+ * MC20_Geofence.cpp
+ * A library for SeeedStudio GPS Tracker geofencing
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "MC20_Geofence.h"
+#include "MC20_Geo.h"
+
+/* GeofenceEngine::state bits */
+#define STATE_INSIDE    0x80        // enter confirmed
+#define STATE_COUNT     0x7F        // consecutive fixes disagreeing with STATE_INSIDE
+
+/* Bounding box of a fence, degrees * 1e7 */
+static void fenceBounds(const Geofence &fence, const Geofence_Point *vertices,
+                        int32_t *minLat, int32_t *minLon, int32_t *maxLat, int32_t *maxLon)
+{
+    if(fence.type == GEOFENCE_CIRCLE){
+        int32_t dLat = (int32_t)(((int64_t)fence.data << 16) / LAT_SCALE_Q16) + 1;
+        int32_t dLon = (int32_t)(((int64_t)fence.data << 16) / Geo_lonScaleQ16(fence.latitude)) + 1;
+
+        *minLat = fence.latitude - dLat;
+        *maxLat = fence.latitude + dLat;
+        *minLon = fence.longitude - dLon;
+        *maxLon = fence.longitude + dLon;
+        return;
+    }
+
+    const Geofence_Point *v = &vertices[fence.data];
+    *minLat = *maxLat = v[0].latitude;
+    *minLon = *maxLon = v[0].longitude;
+    for(uint8_t i = 1; i < fence.vertexCount; i++){
+        if(v[i].latitude < *minLat) *minLat = v[i].latitude;
+        if(v[i].latitude > *maxLat) *maxLat = v[i].latitude;
+        if(v[i].longitude < *minLon) *minLon = v[i].longitude;
+        if(v[i].longitude > *maxLon) *maxLon = v[i].longitude;
+    }
+}
+
+/* Clamp a coordinate to a cell number along one axis */
+static int32_t cellOf(int32_t value, int32_t origin, int32_t size, uint8_t cells)
+{
+    int64_t cell = ((int64_t)value - origin) / size;
+
+    if(cell < 0) return 0;
+    if(cell >= cells) return cells - 1;
+    return (int32_t)cell;
+}
+
+GeofenceEngine::GeofenceEngine(const Geofence *fences, uint16_t count, const Geofence_Point *vertices,
+                               const Geofence_Grid *grid, uint8_t *state)
+{
+    this->fences = fences;
+    this->count = count;
+    this->vertices = vertices;
+    this->grid = grid;
+    this->state = state;
+    confirm = 2;
+    margin = 1000;
+    callback = NULL;
+    activeCount = 0;
+    overflow = false;
+    lonScale = 0;
+    scaleLatitude = 0;
+    tested = 0;
+    overflows = 0;
+    memset(state, 0, count);
+}
+
+uint16_t GeofenceEngine::buildIndex(const Geofence *fences, uint16_t count, const Geofence_Point *vertices,
+                                    uint8_t columns, uint8_t rows, uint16_t *cellStart,
+                                    uint16_t *cellFences, uint16_t maxEntries, Geofence_Grid *grid)
+{
+    int32_t minLat, minLon, maxLat, maxLon;
+    int32_t gridMinLat = INT32_MAX, gridMinLon = INT32_MAX;
+    int32_t gridMaxLat = INT32_MIN, gridMaxLon = INT32_MIN;
+    uint16_t cells = columns * rows;
+    uint32_t total = 0;
+
+    if(count == 0 || columns == 0 || rows == 0){
+        return 0;
+    }
+
+    for(uint16_t i = 0; i < count; i++){
+        fenceBounds(fences[i], vertices, &minLat, &minLon, &maxLat, &maxLon);
+        if(minLat < gridMinLat) gridMinLat = minLat;
+        if(minLon < gridMinLon) gridMinLon = minLon;
+        if(maxLat > gridMaxLat) gridMaxLat = maxLat;
+        if(maxLon > gridMaxLon) gridMaxLon = maxLon;
+    }
+    grid->minLatitude = gridMinLat;
+    grid->minLongitude = gridMinLon;
+    grid->cellLatitude = (int32_t)(((int64_t)gridMaxLat - gridMinLat) / rows + 1);
+    grid->cellLongitude = (int32_t)(((int64_t)gridMaxLon - gridMinLon) / columns + 1);
+    grid->columns = columns;
+    grid->rows = rows;
+    grid->cellStart = cellStart;
+    grid->cellFences = cellFences;
+
+    // Pass 1: count fences per cell
+    memset(cellStart, 0, (cells + 1) * sizeof(uint16_t));
+    for(uint16_t i = 0; i < count; i++){
+        fenceBounds(fences[i], vertices, &minLat, &minLon, &maxLat, &maxLon);
+        int32_t r0 = cellOf(minLat, gridMinLat, grid->cellLatitude, rows);
+        int32_t r1 = cellOf(maxLat, gridMinLat, grid->cellLatitude, rows);
+        int32_t c0 = cellOf(minLon, gridMinLon, grid->cellLongitude, columns);
+        int32_t c1 = cellOf(maxLon, gridMinLon, grid->cellLongitude, columns);
+        for(int32_t r = r0; r <= r1; r++){
+            for(int32_t c = c0; c <= c1; c++){
+                cellStart[r*columns + c]++;
+            }
+        }
+        total += (r1 - r0 + 1) * (c1 - c0 + 1);
+    }
+    if(total > maxEntries){
+        return 0;
+    }
+
+    // Running sum, cellStart[c] is now the end of cell c
+    for(uint16_t c = 1; c < cells; c++){
+        cellStart[c] += cellStart[c - 1];
+    }
+    cellStart[cells] = total;
+
+    // Pass 2: fill backwards, leaving cellStart[c] at the start of cell c
+    // and every cell sorted by fence index
+    for(uint16_t i = count; i-- > 0;){
+        fenceBounds(fences[i], vertices, &minLat, &minLon, &maxLat, &maxLon);
+        int32_t r0 = cellOf(minLat, gridMinLat, grid->cellLatitude, rows);
+        int32_t r1 = cellOf(maxLat, gridMinLat, grid->cellLatitude, rows);
+        int32_t c0 = cellOf(minLon, gridMinLon, grid->cellLongitude, columns);
+        int32_t c1 = cellOf(maxLon, gridMinLon, grid->cellLongitude, columns);
+        for(int32_t r = r0; r <= r1; r++){
+            for(int32_t c = c0; c <= c1; c++){
+                cellFences[--cellStart[r*columns + c]] = i;
+            }
+        }
+    }
+
+    return total;
+}
+
+void GeofenceEngine::setHysteresis(uint8_t confirm, uint32_t margin)
+{
+    this->confirm = confirm < 1 ? 1 : (confirm > STATE_COUNT ? STATE_COUNT : confirm);
+    this->margin = margin;
+}
+
+bool GeofenceEngine::isInside(uint16_t index) const
+{
+    return index < count && (state[index] & STATE_INSIDE);
+}
+
+/* Crossing number, edges intersected by a ray running east from the point.
+ * The intersection test is done as a cross product sign in 64 bit so there
+ * is no division and no rounding.
+ */
+bool GeofenceEngine::insidePolygon(const Geofence_Point *v, uint8_t count, int32_t latitude, int32_t longitude)
+{
+    bool inside = false;
+
+    for(uint8_t i = 0, j = count - 1; i < count; j = i++){
+        int32_t yi = v[i].latitude;
+        int32_t yj = v[j].latitude;
+
+        if((yi > latitude) != (yj > latitude)){
+            int64_t cross = ((int64_t)v[j].longitude - v[i].longitude) * ((int64_t)latitude - yi)
+                          - ((int64_t)longitude - v[i].longitude) * ((int64_t)yj - yi);
+            if(yj > yi ? cross > 0 : cross < 0){
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+bool GeofenceEngine::insideCircle(const Geofence &fence, int32_t latitude, int32_t longitude,
+                                  uint32_t margin, int32_t lonScale)
+{
+    int64_t radius = (int64_t)fence.data + margin;
+    int64_t dy = ((int64_t)(latitude - fence.latitude) * LAT_SCALE_Q16) >> 16;
+    int64_t dx;
+
+    if(dy > radius || dy < -radius){
+        return false;
+    }
+    dx = ((int64_t)(longitude - fence.longitude) * lonScale) >> 16;
+    if(dx > radius || dx < -radius){
+        return false;
+    }
+    return dx*dx + dy*dy <= radius*radius;
+}
+
+bool GeofenceEngine::isActive(uint16_t index) const
+{
+    for(uint8_t i = 0; i < activeCount; i++){
+        if(active[i] == index){
+            return true;
+        }
+    }
+    return false;
+}
+
+void GeofenceEngine::activate(uint16_t index)
+{
+    if(isActive(index)){
+        return;
+    }
+    if(activeCount < GEOFENCE_MAX_ACTIVE){
+        active[activeCount++] = index;
+    } else {
+        // update() scans for it until there is room
+        overflow = true;
+        overflows++;
+    }
+}
+
+void GeofenceEngine::deactivate(uint16_t index)
+{
+    for(uint8_t i = 0; i < activeCount; i++){
+        if(active[i] == index){
+            active[i] = active[--activeCount];
+            return;
+        }
+    }
+}
+
+/* Test one fence and run its hysteresis, true if an event was raised */
+bool GeofenceEngine::evaluate(uint16_t index, const GNSS_Fix &fix)
+{
+    const Geofence &fence = fences[index];
+    uint8_t s = state[index];
+    bool inside = s & STATE_INSIDE;
+    bool hit;
+
+    tested++;
+    if(fence.type == GEOFENCE_CIRCLE){
+        // Leaving a circle needs the margin on top of the radius
+        hit = insideCircle(fence, fix.latitude, fix.longitude, inside ? margin : 0, lonScale);
+    } else {
+        hit = insidePolygon(&vertices[fence.data], fence.vertexCount, fix.latitude, fix.longitude);
+    }
+
+    if(hit == inside){
+        state[index] = s & STATE_INSIDE;
+        if(!inside){
+            deactivate(index);
+        }
+        return false;
+    }
+
+    if((s & STATE_COUNT) + 1 < confirm){
+        state[index] = s + 1;
+        activate(index);
+        return false;
+    }
+
+    state[index] = inside ? 0 : STATE_INSIDE;
+    if(inside){
+        deactivate(index);
+    } else {
+        activate(index);
+    }
+    if(NULL != callback){
+        callback(fence.id, !inside, fix);
+    }
+    return true;
+}
+
+uint8_t GeofenceEngine::update(const GNSS_Fix &fix)
+{
+    const uint16_t *cellFences = NULL;
+    uint16_t cellCount = 0;
+    uint16_t pending[GEOFENCE_MAX_ACTIVE];
+    uint8_t pendingCount;
+    uint8_t events = 0;
+
+    if(!(fix.flags & FIX_VALID)){
+        return 0;
+    }
+
+    Geo_updateLonScale(fix.latitude, &lonScale, &scaleLatitude);
+
+    // Two divisions to find the cell, fixes outside the grid only check active fences
+    if(fix.latitude >= grid->minLatitude && fix.longitude >= grid->minLongitude){
+        uint32_t row = (uint32_t)((int64_t)fix.latitude - grid->minLatitude) / grid->cellLatitude;
+        uint32_t column = (uint32_t)((int64_t)fix.longitude - grid->minLongitude) / grid->cellLongitude;
+
+        if(row < grid->rows && column < grid->columns){
+            uint16_t cell = row * grid->columns + column;
+            cellFences = &grid->cellFences[grid->cellStart[cell]];
+            cellCount = grid->cellStart[cell + 1] - grid->cellStart[cell];
+        }
+    }
+
+    // evaluate() edits the active list, walk a copy of it
+    pendingCount = activeCount;
+    memcpy(pending, active, activeCount * sizeof(uint16_t));
+
+    for(uint16_t i = 0; i < cellCount; i++){
+        if(evaluate(cellFences[i], fix)){
+            events++;
+        }
+    }
+    for(uint8_t i = 0; i < pendingCount; i++){
+        bool inCell = false;
+        for(uint16_t j = 0; j < cellCount; j++){
+            if(cellFences[j] == pending[i]){
+                inCell = true;
+                break;
+            }
+        }
+        if(!inCell && evaluate(pending[i], fix)){
+            events++;
+        }
+    }
+
+    // Fences left out of the full list: their state bytes tell which, those
+    // not tested above are tested now and listed once there is room
+    if(overflow){
+        uint16_t next = 0;
+
+        overflow = false;
+        for(uint16_t i = 0; i < count; i++){
+            if(state[i] == 0 || isActive(i)){
+                continue;
+            }
+            // Cells are sorted by fence index
+            while(next < cellCount && cellFences[next] < i){
+                next++;
+            }
+            if((next == cellCount || cellFences[next] != i) && evaluate(i, fix)){
+                events++;
+            }
+            if(state[i] != 0 && !isActive(i)){
+                if(activeCount < GEOFENCE_MAX_ACTIVE){
+                    active[activeCount++] = i;
+                } else {
+                    overflow = true;
+                }
+            }
+        }
+    }
+
+    return events;
+}
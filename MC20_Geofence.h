@@ -0,0 +1,163 @@
+/*
+ * MC20_Geofence.h
+ * A library for SeeedStudio GPS Tracker geofencing
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_GEOFENCE_H__
+#define __MC20_GEOFENCE_H__
+
+#include <stdint.h>
+#include "MC20_NMEA.h"
+
+/* Fences that can be inside / pending at the same time, checked on every
+ * fix even after leaving their grid cells so that exits are not missed.
+ * Fences past the limit are found by a scan of the state bytes instead,
+ * see GeofenceEngine::overflows. */
+#ifndef GEOFENCE_MAX_ACTIVE
+#define GEOFENCE_MAX_ACTIVE     16
+#endif
+
+enum GEOFENCE_TYPE {
+    GEOFENCE_CIRCLE = 0,
+    GEOFENCE_POLYGON = 1
+};
+
+struct Geofence_Point {
+    int32_t latitude;       // degrees * 1e7
+    int32_t longitude;      // degrees * 1e7
+};
+
+/** One fence, 16 bytes. Declare tables const so they stay in flash:
+ *
+ *      const Geofence_Point vertices[] = {{225830000, 1139650000}, ...};
+ *      const Geofence fences[] = {
+ *          {225840000, 1139660000, 20000, 1, GEOFENCE_CIRCLE, 0},  // 200 m
+ *          {0, 0, 0, 2, GEOFENCE_POLYGON, 4},                      // vertices[0..3]
+ *      };
+ */
+struct Geofence {
+    int32_t  latitude;      // circle center
+    int32_t  longitude;
+    uint32_t data;          // circle: radius in cm, polygon: first vertex
+    uint16_t id;            // reported in events
+    uint8_t  type;          // GEOFENCE_TYPE
+    uint8_t  vertexCount;   // polygon only
+};
+
+/** Uniform grid over the fences' bounding box.
+ *  Cell c lists fences cellFences[cellStart[c]] .. cellFences[cellStart[c+1] - 1],
+ *  cells are numbered row by row from the south-west corner.
+ */
+struct Geofence_Grid {
+    int32_t  minLatitude;
+    int32_t  minLongitude;
+    int32_t  cellLatitude;      // cell size, degrees * 1e7
+    int32_t  cellLongitude;
+    uint8_t  columns;
+    uint8_t  rows;
+    const uint16_t *cellStart;  // columns * rows + 1 entries
+    const uint16_t *cellFences;
+};
+
+typedef void (*Geofence_Callback)(uint16_t id, bool entered, const GNSS_Fix &fix);
+
+class GeofenceEngine
+{
+public:
+    /** @param  fences    fence table, may live in flash
+     *  @param  count     number of fences
+     *  @param  vertices  polygon vertex table, may live in flash
+     *  @param  grid      index from buildIndex(), its tables may live in flash
+     *  @param  state     one byte per fence of RAM for the hysteresis
+     */
+    GeofenceEngine(const Geofence *fences, uint16_t count, const Geofence_Point *vertices,
+                   const Geofence_Grid *grid, uint8_t *state);
+
+    /** Build the grid index for a fence table.
+     *  Run it at start-up, or once on a PC and paste the tables as const.
+     *  @param  cellStart   columns * rows + 1 entries
+     *  @param  cellFences  maxEntries entries
+     *  @returns
+     *      entries used in cellFences, 0 if maxEntries was too small
+     */
+    static uint16_t buildIndex(const Geofence *fences, uint16_t count, const Geofence_Point *vertices,
+                               uint8_t columns, uint8_t rows, uint16_t *cellStart,
+                               uint16_t *cellFences, uint16_t maxEntries, Geofence_Grid *grid);
+
+    /** Consecutive fixes needed to confirm an enter or exit, and the extra
+     *  cm a fix has to be outside a circle before it counts as outside
+     */
+    void setHysteresis(uint8_t confirm, uint32_t margin);
+
+    void setCallback(Geofence_Callback callback) { this->callback = callback; }
+
+    /** Evaluate a fix against the fences of its cell and the active ones.
+     *  While more fences are inside / pending than the active list holds,
+     *  every fence is looked at on each fix until the list has room again.
+     *  @returns
+     *      number of events raised
+     */
+    uint8_t update(const GNSS_Fix &fix);
+
+    /** Whether the fence at table index is currently entered */
+    bool isInside(uint16_t index) const;
+
+    /* Point tests, usable without the engine */
+    static bool insidePolygon(const Geofence_Point *vertices, uint8_t count, int32_t latitude, int32_t longitude);
+    static bool insideCircle(const Geofence &fence, int32_t latitude, int32_t longitude, uint32_t margin, int32_t lonScale);
+
+    uint32_t tested;        // fence tests done, for benchmarking
+    uint32_t overflows;     // times a fence did not fit the active list,
+                            // raise GEOFENCE_MAX_ACTIVE if this grows
+
+private:
+    bool evaluate(uint16_t index, const GNSS_Fix &fix);
+    bool isActive(uint16_t index) const;
+    void activate(uint16_t index);
+    void deactivate(uint16_t index);
+
+    const Geofence *fences;
+    uint16_t count;
+    const Geofence_Point *vertices;
+    const Geofence_Grid *grid;
+    uint8_t *state;
+
+    uint8_t confirm;
+    uint32_t margin;
+    Geofence_Callback callback;
+
+    uint16_t active[GEOFENCE_MAX_ACTIVE];
+    uint8_t activeCount;
+    bool overflow;              // a fence with state is not in the list
+
+    int32_t lonScale;           // cm per 1e-7 degree longitude, Q16
+    int32_t scaleLatitude;      // latitude lonScale was computed for
+};
+
+#endif
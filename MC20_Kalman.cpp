@@ -0,0 +1,250 @@
+/*
+ * MC20_Kalman.cpp
+ * A library for SeeedStudio GPS Tracker position filter
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include "MC20_Kalman.h"
+#include "MC20_Geo.h"
+
+#define GATE_SIGMA_SQ       9           // reject innovations beyond 3 sigma
+#define GATE_MAX_REJECTS    3           // then accept anyway, it was a real jump
+#define REBASE_DISTANCE     5000000L    // cm, move the origin after 50 km
+#define STILL_VELOCITY_VAR  25          // (cm/s)^2 of the zero velocity update
+#define MOTION_THRESHOLD    40          // mg away from 1 g that count as motion
+
+GNSS_Kalman::GNSS_Kalman()
+{
+    setNoise(500, 200, 5);
+    setTiming(30000, 10000);
+    reset();
+    rejected = 0;
+}
+
+void GNSS_Kalman::reset(void)
+{
+    initialized = false;
+    moving = true;
+    lastMotion = 0;
+    rejectStreak = 0;
+}
+
+void GNSS_Kalman::setNoise(uint16_t rangeError, uint16_t moveNoise, uint16_t stillNoise)
+{
+    uere = rangeError;
+    accelMoving = moveNoise;
+    accelStill = stillNoise;
+}
+
+void GNSS_Kalman::setTiming(uint32_t coast, uint32_t still)
+{
+    maxCoast = coast;
+    stillTime = still;
+}
+
+void GNSS_Kalman::updateAccel(int16_t x, int16_t y, int16_t z, uint32_t now)
+{
+    uint32_t magnitude = Geo_isqrt64((int32_t)x*x + (int32_t)y*y + (int32_t)z*z);
+
+    // Gravity alone reads 1000 mg whatever the orientation
+    if(magnitude > 1000 + MOTION_THRESHOLD || magnitude < 1000 - MOTION_THRESHOLD){
+        setMotion(true, now);
+    } else if((uint32_t)(now - lastMotion) > stillTime){
+        moving = false;
+    }
+}
+
+void GNSS_Kalman::setMotion(bool motion, uint32_t now)
+{
+    if(motion){
+        lastMotion = now;
+    }
+    moving = motion;
+}
+
+void GNSS_Kalman::setOrigin(int32_t latitude, int32_t longitude)
+{
+    originLatitude = latitude;
+    originLongitude = longitude;
+    lonScale = Geo_lonScaleQ16(latitude);
+}
+
+void GNSS_Kalman::predictAxis(Kalman_Axis &axis, int32_t dt) const
+{
+    int64_t q = moving ? accelMoving : accelStill;
+    int64_t qdt2 = q*q * dt * dt / 1000000;     // q^2 dt^2, dt in ms
+
+    axis.position += (int32_t)((int64_t)axis.velocity * dt / 1000);
+
+    // P = F P F' + Q, white noise acceleration
+    axis.p00 += (2*axis.p01*dt + axis.p11*dt/1000*dt) / 1000 + qdt2*dt/1000*dt/4000;
+    axis.p01 += axis.p11*dt/1000 + qdt2*dt/2000;
+    axis.p11 += qdt2;
+}
+
+void GNSS_Kalman::updatePosition(Kalman_Axis &axis, int32_t z, int64_t r) const
+{
+    int64_t s = axis.p00 + r;
+    int64_t k0 = (axis.p00 << 16) / s;      // Q16 gains
+    int64_t k1 = (axis.p01 << 16) / s;
+    int64_t y = z - axis.position;
+
+    axis.position += (int32_t)((k0*y) >> 16);
+    axis.velocity += (int32_t)((k1*y) >> 16);
+    axis.p11 -= (k1*axis.p01) >> 16;
+    axis.p00 -= (k0*axis.p00) >> 16;
+    axis.p01 -= (k0*axis.p01) >> 16;
+}
+
+void GNSS_Kalman::clampVelocity(Kalman_Axis &axis) const
+{
+    int64_t s = axis.p11 + STILL_VELOCITY_VAR;
+    int64_t k0 = (axis.p01 << 16) / s;
+    int64_t k1 = (axis.p11 << 16) / s;
+    int64_t y = -axis.velocity;
+
+    axis.position += (int32_t)((k0*y) >> 16);
+    axis.velocity += (int32_t)((k1*y) >> 16);
+    axis.p00 -= (k0*axis.p01) >> 16;
+    axis.p01 -= (k0*axis.p11) >> 16;
+    axis.p11 -= (k1*axis.p11) >> 16;
+}
+
+void GNSS_Kalman::predict(uint32_t now)
+{
+    int32_t dt;
+
+    if(!initialized){
+        return;
+    }
+    dt = now - lastPredict;
+    if(dt <= 0){
+        return;
+    }
+    predictAxis(east, dt);
+    predictAxis(north, dt);
+    lastPredict = now;
+
+    if(!moving && (uint32_t)(now - lastMotion) > stillTime){
+        clampVelocity(east);
+        clampVelocity(north);
+    }
+}
+
+bool GNSS_Kalman::updateFix(const GNSS_Fix &fix, uint32_t now)
+{
+    int64_t sigma;
+    int64_t r;
+    int32_t x, y;
+    int64_t dx, dy;
+    int64_t s;
+
+    if(!(fix.flags & FIX_VALID)){
+        return false;
+    }
+
+    // Position sigma from HDOP, HDOP 1.0 -> uere
+    sigma = (int64_t)(fix.hdop > 0 ? fix.hdop : 100) * uere / 100;
+    r = sigma*sigma;
+
+    if(!initialized){
+        setOrigin(fix.latitude, fix.longitude);
+        east.position = 0;
+        north.position = 0;
+        east.velocity = 0;
+        north.velocity = 0;
+        east.p00 = north.p00 = r;
+        east.p01 = north.p01 = 0;
+        east.p11 = north.p11 = 250000;     // (5 m/s)^2, velocity unknown
+        initialized = true;
+        lastPredict = now;
+        lastFix = now;
+        lastGNSS = fix;
+        return true;
+    }
+
+    predict(now);
+
+    x = (int32_t)(((int64_t)(fix.longitude - originLongitude) * lonScale) >> 16);
+    y = (int32_t)(((int64_t)(fix.latitude - originLatitude) * LAT_SCALE_Q16) >> 16);
+
+    // Gate on the larger axis variance, urban multipath shows up as jumps
+    dx = x - east.position;
+    dy = y - north.position;
+    s = (east.p00 > north.p00 ? east.p00 : north.p00) + r;
+    if(dx*dx + dy*dy > GATE_SIGMA_SQ * s && rejectStreak < GATE_MAX_REJECTS){
+        rejectStreak++;
+        rejected++;
+        return false;
+    }
+    rejectStreak = 0;
+
+    updatePosition(east, x, r);
+    updatePosition(north, y, r);
+    lastFix = now;
+    lastGNSS = fix;
+
+    // Keep the local plane small so the projection stays accurate
+    if(east.position > REBASE_DISTANCE || east.position < -REBASE_DISTANCE ||
+       north.position > REBASE_DISTANCE || north.position < -REBASE_DISTANCE){
+        GNSS_Fix current;
+        getEstimate(&current);
+        setOrigin(current.latitude, current.longitude);
+        east.position = 0;
+        north.position = 0;
+    }
+
+    return true;
+}
+
+bool GNSS_Kalman::getEstimate(GNSS_Fix *fix) const
+{
+    int64_t speedSq;
+
+    if(!initialized){
+        return false;
+    }
+
+    *fix = lastGNSS;
+    fix->latitude = originLatitude + (int32_t)(((int64_t)north.position << 16) / LAT_SCALE_Q16);
+    fix->longitude = originLongitude + (int32_t)(((int64_t)east.position << 16) / lonScale);
+
+    speedSq = (int64_t)east.velocity*east.velocity + (int64_t)north.velocity*north.velocity;
+    fix->speed = Geo_isqrt64(speedSq);
+    if(fix->speed > 0){
+        int32_t course = (int32_t)(atan2((double)east.velocity, (double)north.velocity) * (18000.0 / M_PI));
+        fix->course = course < 0 ? course + 36000 : course;
+    }
+
+    if((uint32_t)(lastPredict - lastFix) > maxCoast){
+        fix->flags &= ~FIX_VALID;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,132 @@
+/*
+ * MC20_Kalman.h
+ * A library for SeeedStudio GPS Tracker position filter
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_KALMAN_H__
+#define __MC20_KALMAN_H__
+
+#include <stdint.h>
+#include "MC20_NMEA.h"
+
+/** One axis of the constant-velocity model.
+ *  Position in cm, velocity in cm/s, covariance in the matching squares.
+ */
+struct Kalman_Axis {
+    int32_t position;
+    int32_t velocity;
+    int64_t p00;    // cm^2
+    int64_t p01;    // cm^2/s
+    int64_t p11;    // cm^2/s^2
+};
+
+/** Fixed-point constant-velocity Kalman filter for GNSS positions.
+ *  East and north are filtered independently in a local plane around the
+ *  first fix. Each fix is weighted by its HDOP, fixes that jump further
+ *  than the gate are dropped, and between fixes (or when GNSS drops out)
+ *  the estimate coasts on the last velocity for up to maxCoast.
+ *
+ *  The accelerometer tells the filter whether the board moves: the
+ *  process noise follows it, and after stillTime without motion velocity
+ *  is clamped to zero, which removes parked jitter from distance totals.
+ *  Board orientation is unknown, so acceleration is not integrated.
+ */
+class GNSS_Kalman
+{
+public:
+    GNSS_Kalman();
+
+    void reset(void);
+
+    /** @param  uere         range error in cm, position sigma = HDOP * uere
+     *  @param  accelMoving  process noise when moving, cm/s^2
+     *  @param  accelStill   process noise when still, cm/s^2
+     */
+    void setNoise(uint16_t uere, uint16_t accelMoving, uint16_t accelStill);
+
+    /** @param  maxCoast   ms an estimate stays valid without a fix
+     *  @param  stillTime  ms without motion before velocity is clamped
+     */
+    void setTiming(uint32_t maxCoast, uint32_t stillTime);
+
+    /** Feed an accelerometer sample in mg (ADXL345: g * 1000) */
+    void updateAccel(int16_t x, int16_t y, int16_t z, uint32_t now);
+
+    /** Override motion detection, e.g. from the ADXL345 activity interrupt */
+    void setMotion(bool moving, uint32_t now);
+
+    /** Fuse a GNSS fix
+     *  @param  now  millis() when the fix arrived
+     *  @returns
+     *      true if the fix was used
+     *      false if it was invalid or rejected by the gate
+     */
+    bool updateFix(const GNSS_Fix &fix, uint32_t now);
+
+    /** Advance the estimate to now without a measurement */
+    void predict(uint32_t now);
+
+    /** Current estimate as a fix (latitude, longitude, speed, course,
+     *  time of the last fix)
+     *  @returns
+     *      false if there is no estimate or it coasted longer than maxCoast
+     */
+    bool getEstimate(GNSS_Fix *fix) const;
+
+    uint32_t rejected;      // fixes dropped by the gate, in total
+
+private:
+    void predictAxis(Kalman_Axis &axis, int32_t dt) const;
+    void updatePosition(Kalman_Axis &axis, int32_t z, int64_t r) const;
+    void clampVelocity(Kalman_Axis &axis) const;
+    void setOrigin(int32_t latitude, int32_t longitude);
+
+    Kalman_Axis east;
+    Kalman_Axis north;
+
+    int32_t originLatitude;
+    int32_t originLongitude;
+    int32_t lonScale;       // cm per 1e-7 degree longitude, Q16
+
+    uint16_t uere;
+    uint16_t accelMoving;
+    uint16_t accelStill;
+    uint32_t maxCoast;
+    uint32_t stillTime;
+
+    bool initialized;
+    bool moving;
+    uint32_t lastMotion;    // millis() of the last motion seen
+    uint8_t rejectStreak;   // fixes dropped in a row, a longer run is a real jump
+    uint32_t lastPredict;
+    uint32_t lastFix;
+    GNSS_Fix lastGNSS;
+};
+
+#endif
@@ -0,0 +1,309 @@
+/*
+ * MC20_LOCUS.cpp
+ * A library for SeeedStudio GPS Tracker LOCUS log decoding
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "MC20_LOCUS.h"
+
+/* Field sizes in content bit order, LOCUS_UTC first */
+static const uint8_t fieldSize[] = {4, 1, 4, 4, 2, 2, 2};
+
+static uint8_t hexValue(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0xFF;
+}
+
+/* Find "$<type>," in line and check its "*hh", returns the body or NULL */
+static const char *findSentence(const char *line, const char *type, const char **star)
+{
+    const char *p = strchr(line, '$');
+    uint8_t checkSum = 0;
+    size_t typeLen = strlen(type);
+
+    if(NULL == p || 0 != strncmp(p + 1, type, typeLen) || p[typeLen + 1] != ','){
+        return NULL;
+    }
+    p++;
+    *star = strchr(p, '*');
+    if(NULL == *star || hexValue((*star)[1]) > 15 || hexValue((*star)[2]) > 15){
+        return NULL;
+    }
+    for(const char *q = p; q < *star; q++){
+        checkSum ^= *q;
+    }
+    if(checkSum != ((hexValue((*star)[1]) << 4) | hexValue((*star)[2]))){
+        return NULL;
+    }
+    return p + typeLen + 1;
+}
+
+static uint32_t readLE(const uint8_t *p, uint8_t size)
+{
+    uint32_t value = 0;
+
+    while(size-- > 0){
+        value = (value << 8) | p[size];
+    }
+    return value;
+}
+
+/* IEEE 754 single to degrees * 1e7 with integer math only, no soft-float */
+static int32_t floatToE7(uint32_t bits)
+{
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127;
+    uint64_t mantissa = (bits & 0x7FFFFF) | 0x800000;
+    int32_t shift = 23 - exponent;
+    int32_t value;
+
+    // Zero, denormals and anything outside +-256 degrees
+    if(exponent < -30 || exponent > 8){
+        return 0;
+    }
+    mantissa *= 10000000ULL;
+    value = (int32_t)((mantissa + (1ULL << (shift - 1))) >> shift);
+
+    return (bits & 0x80000000) ? -value : value;
+}
+
+LOCUS_Decoder::LOCUS_Decoder()
+{
+    callback = NULL;
+    reset();
+}
+
+bool LOCUS_Decoder::reset(uint32_t content)
+{
+    this->content = content;
+    expected = 0;
+    packets = 0;
+    badPackets = 0;
+    records = 0;
+    badRecords = 0;
+    started = false;
+    finished = false;
+    offset = 0;
+    nextPacket = 0;
+    recordLength = 0;
+    skip = 0;
+
+    recordSize = 1;     // checksum
+    for(uint8_t i = 0; i < 32; i++){
+        if(!(content & (1UL << i))){
+            continue;
+        }
+        if(i >= sizeof(fieldSize)){
+            recordSize = 0;
+            return false;
+        }
+        recordSize += fieldSize[i];
+    }
+    return true;
+}
+
+bool LOCUS_Decoder::complete(void) const
+{
+    return started && finished && badPackets == 0 && packets == expected;
+}
+
+bool LOCUS_Decoder::parseStatus(const char *line, LOCUS_Status *status)
+{
+    const char *star;
+    char *p = (char *)findSentence(line, "PMTKLOG", &star);
+
+    if(NULL == p){
+        return false;
+    }
+    // $PMTKLOG,456,0,11,31,2,0,0,0,3769,46*48
+    status->serial = strtoul(p, &p, 10);
+    status->type = strtoul(p + 1, &p, 10);
+    status->mode = strtoul(p + 1, &p, 16);
+    status->content = strtoul(p + 1, &p, 10);
+    status->interval = strtoul(p + 1, &p, 10);
+    status->distance = strtoul(p + 1, &p, 10);
+    status->speed = strtoul(p + 1, &p, 10);
+    status->logging = strtoul(p + 1, &p, 10);
+    status->records = strtoul(p + 1, &p, 10);
+    status->percent = strtoul(p + 1, &p, 10);
+
+    return p == star;
+}
+
+bool LOCUS_Decoder::feedLine(const char *line)
+{
+    const char *star;
+    const char *p = findSentence(line, "PMTKLOX", &star);
+    uint16_t sequence;
+
+    // A corrupted line shows up as a gap in the sequence numbers
+    if(NULL == p){
+        return false;
+    }
+
+    switch(*p){
+    case '0':   // $PMTKLOX,0,<packets>
+        expected = atoi(p + 2);
+        started = true;
+        return true;
+    case '2':   // $PMTKLOX,2
+        finished = true;
+        return true;
+    case '1':   // $PMTKLOX,1,<sequence>,<8 hex digits>,...
+        break;
+    default:
+        return false;
+    }
+
+    p += 2;
+    sequence = atoi(p);
+    if(sequence != nextPacket){
+        // Lost lines: pick up at the right flash address
+        if(sequence > nextPacket){
+            badPackets += sequence - nextPacket;
+        }
+        resync((uint32_t)sequence * LOCUS_LINE_BYTES);
+    }
+    nextPacket = sequence + 1;
+    packets++;
+
+    p = strchr(p, ',');
+    while(NULL != p && p < star){
+        p++;
+        while(p + 1 < star && hexValue(p[0]) <= 15 && hexValue(p[1]) <= 15){
+            feedByte((hexValue(p[0]) << 4) | hexValue(p[1]));
+            p += 2;
+        }
+        p = strchr(p, ',');
+    }
+
+    return true;
+}
+
+void LOCUS_Decoder::resync(uint32_t address)
+{
+    uint16_t position = address & (LOCUS_SECTOR_SIZE - 1);
+
+    offset = address;
+    recordLength = 0;
+    skip = 0;
+    if(recordSize != 0 && position > LOCUS_HEADER_SIZE){
+        uint16_t into = (position - LOCUS_HEADER_SIZE) % recordSize;
+        skip = into ? recordSize - into : 0;
+    }
+}
+
+void LOCUS_Decoder::feedByte(uint8_t b)
+{
+    uint16_t position = offset++ & (LOCUS_SECTOR_SIZE - 1);
+
+    if(recordSize == 0 || position < LOCUS_HEADER_SIZE){
+        return;
+    }
+    if(position == LOCUS_HEADER_SIZE){
+        recordLength = 0;
+        skip = 0;
+    }
+    if(skip > 0){
+        skip--;
+        return;
+    }
+    // Sector tail too short for a record, padding up to the next header
+    if(recordLength == 0 && position + recordSize > LOCUS_SECTOR_SIZE){
+        skip = LOCUS_SECTOR_SIZE;
+        return;
+    }
+
+    record[recordLength++] = b;
+    if(recordLength == recordSize){
+        decodeRecord();
+        recordLength = 0;
+    }
+}
+
+void LOCUS_Decoder::decodeRecord(void)
+{
+    GNSS_Fix fix;
+    const uint8_t *p = record;
+    uint8_t checkSum = 0;
+    uint8_t erased = 0xFF;
+
+    for(uint8_t i = 0; i < recordSize - 1; i++){
+        checkSum ^= record[i];
+        erased &= record[i];
+    }
+    if(erased == 0xFF){
+        return;     // unwritten flash
+    }
+    if(checkSum != record[recordSize - 1]){
+        badRecords++;
+        return;
+    }
+
+    memset(&fix, 0, sizeof(fix));
+    if(content & LOCUS_UTC){
+        fix.time = readLE(p, 4);
+        fix.flags |= FIX_HAS_DATE;
+        p += 4;
+    }
+    if(content & LOCUS_VALID){
+        fix.quality = *p++;
+        if(fix.quality != 0){
+            fix.flags |= FIX_VALID;
+        }
+    }
+    if(content & LOCUS_LAT){
+        fix.latitude = floatToE7(readLE(p, 4));
+        p += 4;
+    }
+    if(content & LOCUS_LON){
+        fix.longitude = floatToE7(readLE(p, 4));
+        p += 4;
+    }
+    if(content & LOCUS_HGT){
+        fix.altitude = (int16_t)readLE(p, 2) * 100L;
+        p += 2;
+    }
+    if(content & LOCUS_SPD){
+        fix.speed = readLE(p, 2) * 250UL / 9;     // km/h to cm/s
+        p += 2;
+    }
+    if(content & LOCUS_TRK){
+        fix.course = readLE(p, 2) * 100U;
+        p += 2;
+    }
+    records++;
+
+    if(NULL != callback){
+        callback(fix);
+    }
+}
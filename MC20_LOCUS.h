@@ -0,0 +1,131 @@
+/*
+ * MC20_LOCUS.h
+ * A library for SeeedStudio GPS Tracker LOCUS log decoding
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_LOCUS_H__
+#define __MC20_LOCUS_H__
+
+#include <stdint.h>
+#include "MC20_NMEA.h"
+
+/* LOCUS flash layout: 4 KB sectors, each starting with a 64 byte header */
+#define LOCUS_SECTOR_SIZE       4096
+#define LOCUS_HEADER_SIZE       64
+#define LOCUS_LINE_BYTES        96      // data bytes in a full $PMTKLOX,1 line
+#define LOCUS_MAX_LINE          256     // "$PMTKLOX,1,n," + 24 words + "*hh"
+#define LOCUS_MAX_RECORD        24
+
+/* Record content bits (PMTK187 / $PMTKLOG content field) */
+#define LOCUS_UTC       0x0001      // uint32 UTC seconds since 1970
+#define LOCUS_VALID     0x0002      // uint8 fix type, 0 = no fix
+#define LOCUS_LAT       0x0004      // float degrees
+#define LOCUS_LON       0x0008      // float degrees
+#define LOCUS_HGT       0x0010      // int16 meters
+#define LOCUS_SPD       0x0020      // uint16 km/h
+#define LOCUS_TRK       0x0040      // uint16 degrees
+
+/* Factory default: UTC, VALID, LAT, LON, HGT + checksum = 16 bytes */
+#define LOCUS_CONTENT_BASIC     (LOCUS_UTC | LOCUS_VALID | LOCUS_LAT | LOCUS_LON | LOCUS_HGT)
+
+/* $PMTKLOG reply to PMTK183 */
+struct LOCUS_Status {
+    uint16_t serial;
+    uint8_t  type;          // 0 overlap, 1 stop when full
+    uint8_t  mode;          // bit mask, sent in hex
+    uint32_t content;       // LOCUS_* bits
+    uint16_t interval;      // seconds
+    uint16_t distance;      // meters
+    uint16_t speed;         // km/h
+    uint8_t  logging;       // 0 logging, 1 stopped
+    uint32_t records;
+    uint8_t  percent;       // flash used
+};
+
+typedef void (*LOCUS_RecordCallback)(const GNSS_Fix &fix);
+
+/** Decoder for the $PMTKLOX dump of PMTK622.
+ *  Lines are fed one at a time, each record that passes its checksum is
+ *  handed to the callback as a GNSS_Fix.
+ */
+class LOCUS_Decoder
+{
+public:
+    LOCUS_Decoder();
+
+    /** Start a new dump
+     *  @param  content  LOCUS_* bits the records were logged with
+     *  @returns
+     *      false if content has fields this decoder does not know
+     */
+    bool reset(uint32_t content = LOCUS_CONTENT_BASIC);
+
+    void setCallback(LOCUS_RecordCallback callback) { this->callback = callback; }
+
+    /** Feed one line, anything before '$' is skipped
+     *  @returns
+     *      true if it was a $PMTKLOX line with a valid checksum
+     */
+    bool feedLine(const char *line);
+
+    /** Parse a $PMTKLOG line
+     *  @returns
+     *      true if it was a $PMTKLOG line with a valid checksum
+     */
+    static bool parseStatus(const char *line, LOCUS_Status *status);
+
+    /** Start and end markers seen and no packet lost
+     */
+    bool complete(void) const;
+
+    /* Statistics */
+    uint16_t expected;      // packets announced by $PMTKLOX,0
+    uint16_t packets;       // data packets with a valid checksum
+    uint16_t badPackets;    // data packets lost or failing the checksum
+    uint32_t records;       // records decoded
+    uint32_t badRecords;    // records failing their checksum
+    bool started;
+    bool finished;
+
+private:
+    void resync(uint32_t address);
+    void feedByte(uint8_t b);
+    void decodeRecord(void);
+
+    LOCUS_RecordCallback callback;
+    uint32_t content;
+    uint8_t recordSize;     // 0 when content can not be decoded
+    uint32_t offset;        // flash address of the next byte
+    uint16_t nextPacket;
+    uint8_t record[LOCUS_MAX_RECORD];
+    uint8_t recordLength;
+    uint16_t skip;          // bytes to drop before the next record boundary
+};
+
+#endif
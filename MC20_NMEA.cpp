@@ -0,0 +1,321 @@
+/*
+ * MC20_NMEA.cpp
+ * A library for SeeedStudio GPS Tracker NMEA parsing
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "MC20_NMEA.h"
+
+#define NMEA_MAX_FIELDS   24
+
+static uint8_t hexValue(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0xFF;
+}
+
+/* Parse "[-]123.4567" into an integer scaled by 10^decimals, extra digits
+ * are truncated. Empty fields give 0.
+ */
+static int32_t parseFixed(const char *s, uint8_t decimals)
+{
+    int32_t value = 0;
+    bool negative = false;
+
+    if(*s == '-'){
+        negative = true;
+        s++;
+    }
+    while(*s >= '0' && *s <= '9'){
+        value = value*10 + (*s++ - '0');
+    }
+    if(*s == '.'){
+        s++;
+    }
+    while(decimals > 0){
+        value *= 10;
+        if(*s >= '0' && *s <= '9'){
+            value += *s++ - '0';
+        }
+        decimals--;
+    }
+
+    return negative ? -value : value;
+}
+
+/* "ddmm.mmmmm" / "dddmm.mmmmm" to degrees * 1e7 */
+static int32_t parseCoordinate(const char *s, const char *hemisphere)
+{
+    int32_t value = parseFixed(s, 5);                 // minutes * 1e5, degrees in front
+    int32_t degrees = value / 10000000;
+    int32_t minutes = value % 10000000;
+    int32_t result = degrees*10000000 + minutes*5/3;  // minutes * 1e5 * 100 / 60
+
+    if(*hemisphere == 'S' || *hemisphere == 'W'){
+        result = -result;
+    }
+    return result;
+}
+
+/* Days since 1970-01-01, valid for years 2000 - 2099 */
+static uint32_t daysFromDate(uint16_t year, uint8_t month, uint8_t day)
+{
+    static const uint16_t monthDays[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    uint32_t days = (year - 1970)*365UL + (year - 1969)/4;
+
+    if(month < 1 || month > 12){
+        return 0;
+    }
+    days += monthDays[month - 1] + day - 1;
+    if(month > 2 && (year % 4) == 0){
+        days++;
+    }
+    return days;
+}
+
+NMEA_Parser::NMEA_Parser()
+{
+    fixSentences = NMEA_GGA | NMEA_RMC;
+    reset();
+}
+
+void NMEA_Parser::reset(void)
+{
+    length = 0;
+    inSentence = false;
+    memset(&fix, 0, sizeof(fix));
+    memset(&pending, 0, sizeof(pending));
+    pendingTime = 0;
+    pendingSeen = 0;
+    pendingReported = true;
+    dayStart = 0;
+    bytes = 0;
+    sentences = 0;
+    errors = 0;
+    epochs = 0;
+}
+
+bool NMEA_Parser::feed(char c)
+{
+    bytes++;
+
+    if(c == '$'){
+        // A new sentence always restarts, even if the last one was cut off
+        line[0] = c;
+        length = 1;
+        inSentence = true;
+        return false;
+    }
+    if(!inSentence){
+        return false;
+    }
+    if(c == '\r' || c == '\n'){
+        inSentence = false;
+        line[length] = '\0';
+        return parseSentence();
+    }
+    if(length >= NMEA_MAX_SENTENCE - 1){
+        inSentence = false;
+        errors++;
+        return false;
+    }
+    line[length++] = c;
+
+    return false;
+}
+
+bool NMEA_Parser::feed(const char *data, size_t len)
+{
+    bool ret = false;
+
+    for(size_t i = 0; i < len; i++){
+        if(feed(data[i])){
+            ret = true;
+        }
+    }
+    return ret;
+}
+
+bool NMEA_Parser::parseSentence(void)
+{
+    char *fields[NMEA_MAX_FIELDS];
+    uint8_t count = 0;
+    uint8_t checkSum = 0;
+    char *star;
+    char *p;
+
+    // Verify "*hh" against the XOR of everything between '$' and '*'
+    star = strchr(line, '*');
+    if(NULL == star || star[1] == '\0' || star[2] == '\0'){
+        errors++;
+        return false;
+    }
+    for(p = &line[1]; p < star; p++){
+        checkSum ^= *p;
+    }
+    if(checkSum != ((hexValue(star[1]) << 4) | hexValue(star[2]))){
+        errors++;
+        return false;
+    }
+    *star = '\0';
+    sentences++;
+
+    // Split in place, strtok would merge empty fields
+    p = &line[1];
+    fields[count++] = p;
+    while(NULL != (p = strchr(p, ',')) && count < NMEA_MAX_FIELDS){
+        *p++ = '\0';
+        fields[count++] = p;
+    }
+
+    // Skip the talker id, GP/GL/GN/BD/GB all use the same layout
+    if(strlen(fields[0]) != 5){
+        return false;
+    }
+    if(0 == strcmp(&fields[0][2], "GGA")){
+        return parseGGA(fields, count);
+    } else if(0 == strcmp(&fields[0][2], "RMC")){
+        return parseRMC(fields, count);
+    }
+
+    return false;
+}
+
+bool NMEA_Parser::beginEpoch(const char *time)
+{
+    int32_t value = parseFixed(time, 3);    // hhmmss * 1000 + ms
+    uint32_t msOfDay = (value / 10000000)*3600000UL + ((value / 100000) % 100)*60000UL + (value % 100000);
+    bool flushed = false;
+
+    if(msOfDay == pendingTime && pendingSeen){
+        return false;
+    }
+
+    // New epoch: report the previous one if it never became complete
+    if(pendingSeen && !pendingReported){
+        flushed = completeEpoch();
+    }
+    memset(&pending, 0, sizeof(pending));
+    pendingTime = msOfDay;
+    pendingSeen = 0;
+    pendingReported = false;
+
+    return flushed;
+}
+
+bool NMEA_Parser::completeEpoch(void)
+{
+    pending.msec = pendingTime % 1000;
+    if(dayStart != 0){
+        pending.time = dayStart + pendingTime / 1000;
+        pending.flags |= FIX_HAS_DATE;
+    } else {
+        pending.time = pendingTime / 1000;
+    }
+    fix = pending;
+    pendingReported = true;
+    epochs++;
+
+    return true;
+}
+
+/* $GNGGA,093359.000,2235.0189,N,11357.9816,E,2,17,0.80,35.6,M,-2.5,M,,*51 */
+bool NMEA_Parser::parseGGA(char **fields, uint8_t count)
+{
+    bool flushed;
+
+    if(count < 10){
+        return false;
+    }
+    flushed = beginEpoch(fields[1]);
+
+    pending.quality = parseFixed(fields[6], 0);
+    if(pending.quality > 0){
+        pending.latitude = parseCoordinate(fields[2], fields[3]);
+        pending.longitude = parseCoordinate(fields[4], fields[5]);
+        pending.altitude = parseFixed(fields[9], 2);
+        pending.flags |= FIX_VALID;
+    }
+    pending.satellites = parseFixed(fields[7], 0);
+    pending.hdop = parseFixed(fields[8], 2);
+    pendingSeen |= NMEA_GGA;
+
+    if(!pendingReported && (pendingSeen & fixSentences) == fixSentences){
+        return completeEpoch();
+    }
+    return flushed;
+}
+
+/* $GNRMC,093359.000,A,2235.0189,N,11357.9816,E,0.15,187.26,180417,,,D*70 */
+bool NMEA_Parser::parseRMC(char **fields, uint8_t count)
+{
+    bool flushed;
+    int32_t date;
+
+    if(count < 10){
+        return false;
+    }
+    flushed = beginEpoch(fields[1]);
+
+    date = parseFixed(fields[9], 0);    // ddmmyy
+    if(date > 0){
+        dayStart = daysFromDate(2000 + date % 100, (date / 100) % 100, date / 10000) * 86400UL;
+    }
+    if(fields[2][0] == 'A'){
+        pending.latitude = parseCoordinate(fields[3], fields[4]);
+        pending.longitude = parseCoordinate(fields[5], fields[6]);
+        // knots * 1e3 to cm/s, 1 knot = 51.4444 cm/s
+        pending.speed = (uint16_t)(((uint64_t)parseFixed(fields[7], 3) * 514444UL) / 10000000UL);
+        pending.course = parseFixed(fields[8], 2);
+        pending.flags |= FIX_VALID;
+    }
+    pendingSeen |= NMEA_RMC;
+
+    if(!pendingReported && (pendingSeen & fixSentences) == fixSentences){
+        return completeEpoch();
+    }
+    return flushed;
+}
+
+char *NMEA_Parser::formatCoordinate(char *buffer, int32_t value, uint8_t digits)
+{
+    static const int32_t divider[8] = {10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+    uint32_t magnitude = value < 0 ? -(int64_t)value : value;
+
+    if(digits < 1) digits = 1;
+    if(digits > 7) digits = 7;
+    sprintf(buffer, "%s%lu.%0*lu", value < 0 ? "-" : "",
+            (unsigned long)(magnitude / 10000000UL), digits,
+            (unsigned long)((magnitude % 10000000UL) / divider[digits]));
+
+    return buffer;
+}
@@ -0,0 +1,147 @@
+/*
+ * MC20_NMEA.h
+ * A library for SeeedStudio GPS Tracker NMEA parsing
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_NMEA_H__
+#define __MC20_NMEA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define NMEA_MAX_SENTENCE    96   // NMEA 0183 allows 82, leave room for long GSV
+
+/* Sentence types, also used as bits of NMEA_Parser::fixSentences */
+#define NMEA_GGA    0x01
+#define NMEA_RMC    0x02
+#define NMEA_GSA    0x04
+#define NMEA_GSV    0x08
+#define NMEA_VTG    0x10
+#define NMEA_GLL    0x20
+
+/* GNSS_Fix::flags */
+#define FIX_HAS_DATE    0x01   // time is full UTC, otherwise seconds of day
+#define FIX_VALID       0x02   // RMC status 'A' or GGA quality > 0
+
+/** XOR checksum of a sentence body (between '$' and '*').
+ *  constexpr, so checksums of constant commands are worked out by the compiler.
+ */
+constexpr uint8_t NMEA_checkSum(const char *body, uint8_t sum = 0)
+{
+    return (*body == '\0' || *body == '*') ? sum : NMEA_checkSum(body + 1, sum ^ (uint8_t)*body);
+}
+
+/** One navigation epoch in fixed-point.
+ *  Doubles are soft-float on the SAMD21, so everything downstream of the
+ *  parser works on these integers.
+ */
+struct GNSS_Fix {
+    uint32_t time;        // UTC seconds since 1970-01-01
+    int32_t  latitude;    // degrees * 1e7, north positive
+    int32_t  longitude;   // degrees * 1e7, east positive
+    int32_t  altitude;    // centimeters above MSL
+    uint16_t speed;       // centimeters per second
+    uint16_t course;      // degrees * 100
+    uint16_t hdop;        // HDOP * 100
+    uint16_t msec;        // milliseconds part of time
+    uint8_t  quality;     // GGA fix quality, 0 = no fix
+    uint8_t  satellites;  // satellites used
+    uint8_t  flags;
+};
+
+/** Incremental NMEA 0183 parser.
+ *  Bytes are fed one at a time as they come off the UART, anything before
+ *  a '$' (AT echo, "+QGNSSRD: " prefixes, URC headers) is skipped.
+ */
+class NMEA_Parser
+{
+public:
+    NMEA_Parser();
+
+    /** Reset parser state and counters
+     */
+    void reset(void);
+
+    /** Feed one byte of the NMEA stream
+     *  @param  c  next byte from the modem
+     *  @returns
+     *      true when this byte completed a fix, read it with getFix()
+     *      false otherwise
+     */
+    bool feed(char c);
+
+    /** Feed a buffer, e.g. the response of AT+QGNSSRD?
+     *  @returns
+     *      true if at least one fix was completed
+     */
+    bool feed(const char *data, size_t len);
+
+    /** Last completed fix
+     */
+    const GNSS_Fix &getFix(void) const { return fix; }
+
+    /** Convert a fixed-point coordinate into a decimal string without %f
+     *  @param  buffer  at least 13 bytes
+     *  @param  value   degrees * 1e7
+     *  @param  digits  decimals to print, 1 - 7
+     */
+    static char *formatCoordinate(char *buffer, int32_t value, uint8_t digits = 6);
+
+    /** Sentence types that must be seen for an epoch before it is reported,
+     *  NMEA_GGA | NMEA_RMC by default. An epoch missing some of them is still
+     *  reported as soon as the next epoch starts.
+     */
+    uint8_t fixSentences;
+
+    /* Statistics */
+    uint32_t bytes;           // bytes fed
+    uint32_t sentences;       // sentences with a valid checksum
+    uint32_t errors;          // sentences dropped for checksum or overflow
+    uint32_t epochs;          // fixes reported
+
+private:
+    bool parseSentence(void);
+    bool parseGGA(char **fields, uint8_t count);
+    bool parseRMC(char **fields, uint8_t count);
+    bool beginEpoch(const char *time);
+    bool completeEpoch(void);
+
+    char line[NMEA_MAX_SENTENCE];
+    uint8_t length;
+    bool inSentence;
+
+    GNSS_Fix fix;        // last reported fix
+    GNSS_Fix pending;    // epoch being assembled
+    uint32_t pendingTime;    // hhmmss.sss as integer milliseconds of day
+    uint32_t dayStart;       // UTC seconds of 00:00 of the last RMC date
+    uint8_t pendingSeen;
+    bool pendingReported;
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * MC20_NMEALog.cpp
+ * A library for SeeedStudio GPS Tracker raw NMEA capture
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include "MC20_NMEALog.h"
+
+NMEA_Recorder::NMEA_Recorder()
+{
+    length = 0;
+    active = 0;
+    pending = false;
+    lineStart = true;
+    unflushed = 0;
+    bytes = 0;
+    overruns = 0;
+}
+
+bool NMEA_Recorder::begin(const char *name)
+{
+    uint32_t size;
+
+    file = SD.open(name, NMEALOG_OPEN_MODE);
+    if(!file){
+        return false;
+    }
+    size = file.size();
+    active = 0;
+    length = size % NMEALOG_BUFFER;
+    pending = false;
+
+    // Carry on from the start of the last block, end() left it partial
+    if(!file.seek(size - length) || file.read(buffers[active], length) != (int)length ||
+       !file.seek(size - length)){
+        file.close();
+        return false;
+    }
+    lineStart = length == 0 || buffers[active][length - 1] == '\n' || buffers[active][length - 1] == '\r';
+
+    return true;
+}
+
+void NMEA_Recorder::put(char c)
+{
+    if(length == NMEALOG_BUFFER){
+        if(pending){
+            overruns++;
+            return;
+        }
+        pending = true;
+        active ^= 1;
+        length = 0;
+    }
+    buffers[active][length++] = c;
+}
+
+void NMEA_Recorder::write(char c)
+{
+    if(!file){
+        return;
+    }
+    if(c == '\r' || c == '\n'){
+        lineStart = true;
+    } else if(lineStart){
+        char stamp[12];
+        lineStart = false;
+        sprintf(stamp, "%lu ", (unsigned long)millis());
+        for(char *p = stamp; *p != '\0'; p++){
+            put(*p);
+        }
+    }
+    put(c);
+}
+
+bool NMEA_Recorder::service(void)
+{
+    if(!pending){
+        return false;
+    }
+    bytes += file.write((const uint8_t *)buffers[active ^ 1], NMEALOG_BUFFER);
+    pending = false;
+
+    // The data is on the card already, this only updates the file size
+    if(++unflushed >= NMEALOG_FLUSH_INTERVAL){
+        file.flush();
+        unflushed = 0;
+    }
+    return true;
+}
+
+void NMEA_Recorder::end(void)
+{
+    if(!file){
+        return;
+    }
+    service();
+    bytes += file.write((const uint8_t *)buffers[active], length);
+    length = 0;
+    file.close();
+}
@@ -0,0 +1,99 @@
+/*
+ * MC20_NMEALog.h
+ * A library for SeeedStudio GPS Tracker raw NMEA capture
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_NMEALOG_H__
+#define __MC20_NMEALOG_H__
+
+#include <Arduino.h>
+#include <SD.h>
+
+#define NMEALOG_BUFFER          512     // bytes per buffer, one SD block
+#define NMEALOG_FLUSH_INTERVAL  16      // buffers between directory updates, 8 KB
+
+/* FILE_WRITE includes O_APPEND, begin() has to seek back to a block boundary */
+#define NMEALOG_OPEN_MODE       (O_READ | O_WRITE | O_CREAT)
+
+/** Raw NMEA capture to the SD card.
+ *  write() only copies into one of two 512 byte buffers, so it can sit
+ *  in the byte path of the parser (GNSS::setNMEATee()). When a buffer
+ *  fills up the other one takes over and service(), called from loop(),
+ *  writes the full one as a single block. Bytes that arrive while both
+ *  buffers are full are dropped and counted in overruns.
+ *
+ *  Each line is prefixed with millis() and a space:
+ *      123456 $GNRMC,...
+ *  NMEA_Parser skips anything before '$', so the file replays as it is
+ *  through the parser, e.g. GNSS_Kalman_Replay or a host build.
+ */
+class NMEA_Recorder
+{
+public:
+    NMEA_Recorder();
+
+    /** Open the file for appending. A partial last block is read back
+     *  into the buffer and rewritten whole, so every write stays aligned.
+     *  @returns
+     *      true on success
+     *      false if the file can not be opened
+     */
+    bool begin(const char *name);
+
+    /** Buffer one byte of the stream, never touches the card
+     */
+    void write(char c);
+
+    /** Write a full buffer if there is one, at most one block per call
+     *  @returns
+     *      true if a block was written
+     */
+    bool service(void);
+
+    /** Write everything buffered and close the file
+     */
+    void end(void);
+
+    /* Statistics */
+    uint32_t bytes;         // bytes written to the card
+    uint32_t overruns;      // bytes dropped, service() not called often enough
+
+private:
+    void put(char c);
+
+    File file;
+    char buffers[2][NMEALOG_BUFFER];
+    uint16_t length;        // bytes in the active buffer
+    uint8_t active;         // buffer being filled
+    bool pending;           // the other buffer is full and not written yet
+    bool lineStart;
+    uint8_t unflushed;      // blocks written since the last flush
+};
+
+#endif
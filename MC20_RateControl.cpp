@@ -0,0 +1,119 @@
+/*
+ * MC20_RateControl.cpp
+ * A library for SeeedStudio GPS Tracker GNSS rate control
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "MC20_RateControl.h"
+
+static const GNSS_RateLevel defaultLevels[] = {
+    // enter, exit,  fix,    poll
+    {    0,    0, 10000, 30000},    // parked
+    {  140,   80,  5000,  5000},    // walking / city, above 5 km/h
+    { 1100,  700,  1000,  1000},    // road, above 40 km/h
+};
+
+GNSS_RateController::GNSS_RateController()
+{
+    setLevels(defaultLevels, sizeof(defaultLevels) / sizeof(defaultLevels[0]));
+    setHysteresis(30, 2000, 200);
+}
+
+void GNSS_RateController::setLevels(const GNSS_RateLevel *table, uint8_t count)
+{
+    if(count > RATE_MAX_LEVELS){
+        count = RATE_MAX_LEVELS;
+    }
+    memcpy(levels, table, count * sizeof(GNSS_RateLevel));
+    levelCount = count;
+    level = 0;
+    slow = false;
+    haveCourse = false;
+}
+
+void GNSS_RateController::setHysteresis(uint16_t hold, uint16_t angle, uint16_t minSpeed)
+{
+    holdTime = hold;
+    turnAngle = angle;
+    turnMinSpeed = minSpeed;
+}
+
+bool GNSS_RateController::update(const GNSS_Fix &fix)
+{
+    uint8_t previous = level;
+    uint16_t delta;
+
+    // Without a fix we know nothing about motion, stay where we are
+    if(!(fix.flags & FIX_VALID) || levelCount == 0){
+        return false;
+    }
+
+    // Speed up immediately
+    while(level + 1 < levelCount && fix.speed >= levels[level + 1].enterSpeed){
+        level++;
+    }
+
+    // Turning needs dense points even at moderate speed
+    if(fix.speed >= turnMinSpeed){
+        if(haveCourse && turnAngle > 0){
+            delta = fix.course > lastCourse ? fix.course - lastCourse : lastCourse - fix.course;
+            if(delta > 18000){
+                delta = 36000 - delta;
+            }
+            if(delta >= turnAngle){
+                level = levelCount - 1;
+            }
+        }
+        lastCourse = fix.course;
+        haveCourse = true;
+    } else {
+        haveCourse = false;
+    }
+
+    if(level != previous){
+        slow = false;
+        return true;
+    }
+
+    // Slow down one level at a time, only after holdTime below exitSpeed
+    if(level > 0 && fix.speed < levels[level].exitSpeed){
+        if(!slow){
+            slow = true;
+            slowSince = fix.time;
+        } else if(fix.time - slowSince >= holdTime){
+            level--;
+            slowSince = fix.time;
+            return true;
+        }
+    } else {
+        slow = false;
+    }
+
+    return false;
+}
@@ -0,0 +1,102 @@
+/*
+ * MC20_RateControl.h
+ * A library for SeeedStudio GPS Tracker GNSS rate control
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_RATECONTROL_H__
+#define __MC20_RATECONTROL_H__
+
+#include <stdint.h>
+#include "MC20_NMEA.h"
+
+#define RATE_MAX_LEVELS     4
+
+/** One operating point of the rate controller.
+ *  A level is entered when speed reaches enterSpeed and left (downwards)
+ *  once speed stayed below exitSpeed for the hold time, so exitSpeed should
+ *  be lower than enterSpeed.
+ */
+struct GNSS_RateLevel {
+    uint16_t enterSpeed;    // cm/s
+    uint16_t exitSpeed;     // cm/s
+    uint16_t fixInterval;   // ms, PMTK220 range 100 - 10000
+    uint32_t pollPeriod;    // ms between application work, the NMEA stream is still read every loop
+};
+
+/** Chooses the GNSS fix interval and application poll period from speed
+ *  and heading change in RMC: dense fixes on the move, almost nothing parked.
+ */
+class GNSS_RateController
+{
+public:
+    /** Default levels: parked (10 s fix, 30 s poll), slow below 40 km/h
+     *  (5 s) and fast (1 s).
+     */
+    GNSS_RateController();
+
+    /** Replace the level table, levels must be sorted by speed
+     *  @param  levels  table of at most RATE_MAX_LEVELS entries, copied
+     */
+    void setLevels(const GNSS_RateLevel *levels, uint8_t count);
+
+    /** Configure hysteresis
+     *  @param  holdTime       seconds below exitSpeed before stepping down
+     *  @param  turnAngle      heading change (degrees * 100) between fixes that
+     *                         selects the fastest level, 0 to disable
+     *  @param  turnMinSpeed   cm/s below which course is too noisy to use
+     */
+    void setHysteresis(uint16_t holdTime, uint16_t turnAngle, uint16_t turnMinSpeed);
+
+    /** Feed a fix
+     *  @returns
+     *      true if the level changed, apply fixInterval() to the GNSS
+     *      false otherwise
+     */
+    bool update(const GNSS_Fix &fix);
+
+    uint8_t  getLevel(void) const { return level; }
+    uint16_t fixInterval(void) const { return levels[level].fixInterval; }
+    uint32_t pollPeriod(void) const { return levels[level].pollPeriod; }
+
+private:
+    GNSS_RateLevel levels[RATE_MAX_LEVELS];
+    uint8_t levelCount;
+    uint8_t level;
+
+    uint16_t holdTime;
+    uint16_t turnAngle;
+    uint16_t turnMinSpeed;
+
+    uint32_t slowSince;     // fix time speed first dropped below exitSpeed
+    bool slow;
+    uint16_t lastCourse;
+    bool haveCourse;
+};
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * MC20_Telemetry.cpp
+ * A library for SeeedStudio GPS Tracker UDP telemetry
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "MC20_Telemetry.h"
+
+UDPTelemetry::UDPTelemetry(GPRS &gprs, const char *host, int port) : gprs(gprs)
+{
+    this->host = host;
+    this->port = port;
+    socket = -1;
+    window = 0;
+    sequence = 0;
+    fixCount = 0;
+    ackLength = 0;
+    memset(slots, 0, sizeof(slots));
+    datagrams = 0;
+    bytesSent = 0;
+    retransmits = 0;
+    acked = 0;
+    lost = 0;
+}
+
+bool UDPTelemetry::begin(void)
+{
+    if(isOpen()){
+        return true;
+    }
+    if(gprs.mux){
+        socket = gprs.openSocket(UDP, host, port);
+        return socket >= 0;
+    }
+    socket = -1;
+    return gprs.connectUDP(host, port);
+}
+
+void UDPTelemetry::end(void)
+{
+    flush();
+    if(gprs.mux){
+        if(socket >= 0){
+            gprs.closeSocket(socket);
+        }
+    } else {
+        gprs.closeTCP();
+    }
+    socket = -1;
+    memset(slots, 0, sizeof(slots));
+}
+
+void UDPTelemetry::setAckWindow(uint8_t window)
+{
+    this->window = window < TELEMETRY_WINDOW ? window : TELEMETRY_WINDOW;
+}
+
+uint8_t UDPTelemetry::inFlight(void) const
+{
+    uint8_t n = 0;
+
+    for(uint8_t i = 0; i < TELEMETRY_WINDOW; i++){
+        if(slots[i].length > 0){
+            n++;
+        }
+    }
+    return n;
+}
+
+bool UDPTelemetry::transmit(const uint8_t *data, size_t length)
+{
+    if(!begin()){
+        return false;
+    }
+    if(!gprs.send(data, length, socket)){
+        // Reopened by the next send
+        if(gprs.mux){
+            gprs.closeSocket(socket);
+        } else {
+            gprs.closeTCP();
+        }
+        return false;
+    }
+    bytesSent += length;
+
+    return true;
+}
+
+bool UDPTelemetry::add(const GNSS_Fix &fix)
+{
+    if(!(fix.flags & FIX_VALID)){
+        return false;
+    }
+    fixes[fixCount++] = fix;
+    if(fixCount == TELEMETRY_BATCH_FIXES){
+        return flush();
+    }
+    return true;
+}
+
+/* A free slot, or the oldest one when the window is full */
+Telemetry_Slot *UDPTelemetry::takeSlot(void)
+{
+    Telemetry_Slot *oldest = NULL;
+
+    for(uint8_t i = 0; i < window; i++){
+        if(slots[i].length == 0){
+            return &slots[i];
+        }
+        if(NULL == oldest || (uint16_t)(sequence - slots[i].sequence) > (uint16_t)(sequence - oldest->sequence)){
+            oldest = &slots[i];
+        }
+    }
+    lost++;
+    return oldest;
+}
+
+bool UDPTelemetry::flush(void)
+{
+    Telemetry_Slot *slot;
+    uint8_t checksum = 0;
+    size_t length;
+
+    if(fixCount == 0){
+        return true;
+    }
+    length = encoder.encodeBatch(fixes, fixCount, datagram + 4, sizeof(datagram) - 5);
+    fixCount = 0;
+    datagram[0] = TELEMETRY_MAGIC;
+    datagram[1] = TELEMETRY_DATA;
+    datagram[2] = sequence >> 8;
+    datagram[3] = sequence & 0xFF;
+    for(size_t i = 0; i < length; i++){
+        checksum ^= datagram[4 + i];
+    }
+    datagram[4 + length] = checksum;
+    length += 5;
+    datagrams++;
+
+    if(window == 0){
+        sequence++;
+        if(!transmit(datagram, length)){
+            lost++;
+            return false;
+        }
+        return true;
+    }
+
+    // Kept even if the send fails, service() tries again
+    slot = takeSlot();
+    memcpy(slot->data, datagram, length);
+    slot->length = length;
+    slot->sequence = sequence++;
+    slot->tries = 1;
+    slot->sentTime = millis();
+
+    return transmit(slot->data, slot->length);
+}
+
+void UDPTelemetry::acknowledge(uint16_t sequence)
+{
+    for(uint8_t i = 0; i < TELEMETRY_WINDOW; i++){
+        if(slots[i].length > 0 && slots[i].sequence == sequence){
+            slots[i].length = 0;
+            acked++;
+            return;
+        }
+    }
+}
+
+void UDPTelemetry::receiveAcks(void)
+{
+    int c;
+
+    if(gprs.available(socket) == 0){
+        return;
+    }
+    // 0xB7 0x82 <sequence>, resynchronized on the magic byte
+    while((c = gprs.read(socket)) >= 0){
+        if(ackLength == 0 && c != TELEMETRY_MAGIC){
+            continue;
+        }
+        if(ackLength == 1 && c != TELEMETRY_ACK){
+            ackLength = (c == TELEMETRY_MAGIC) ? 1 : 0;
+            continue;
+        }
+        ack[ackLength++] = c;
+        if(ackLength == sizeof(ack)){
+            ackLength = 0;
+            acknowledge(((uint16_t)ack[2] << 8) | ack[3]);
+        }
+    }
+}
+
+void UDPTelemetry::service(void)
+{
+    Telemetry_Slot *slot;
+
+    // A closed socket is reopened by the first retransmission
+    if(isOpen()){
+        receiveAcks();
+    }
+
+    for(uint8_t i = 0; i < TELEMETRY_WINDOW; i++){
+        slot = &slots[i];
+        if(slot->length == 0 || millis() - slot->sentTime < (TELEMETRY_RETRY_MS << (slot->tries - 1))){
+            continue;
+        }
+        if(slot->tries > TELEMETRY_RETRIES){
+            slot->length = 0;
+            lost++;
+            continue;
+        }
+        slot->tries++;
+        slot->sentTime = millis();
+        retransmits++;
+        transmit(slot->data, slot->length);
+    }
+}
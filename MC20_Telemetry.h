@@ -0,0 +1,152 @@
+/*
+ * MC20_Telemetry.h
+ * A library for SeeedStudio GPS Tracker UDP telemetry
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_TELEMETRY_H__
+#define __MC20_TELEMETRY_H__
+
+#include "MC20_GPRS.h"
+#include "MC20_TrackCodec.h"
+
+#define TELEMETRY_BATCH_FIXES   8       // fixes per datagram
+#define TELEMETRY_WINDOW        4       // most datagrams waiting for an ack
+#define TELEMETRY_RETRY_MS      5000UL  // first retransmit, doubled after each try
+#define TELEMETRY_RETRIES       3       // retransmits before a datagram is given up
+
+#define TELEMETRY_MAGIC         0xB7
+#define TELEMETRY_DATA          0x02
+#define TELEMETRY_ACK           0x82
+/* Header, batch count varint, records and checksum: a batch always fits */
+#define TELEMETRY_MAX_DATAGRAM  (4 + 3 + TELEMETRY_BATCH_FIXES * TRACK_MAX_RECORD + 1)
+
+/* A sent datagram kept for retransmission */
+struct Telemetry_Slot {
+    uint8_t data[TELEMETRY_MAX_DATAGRAM];
+    uint16_t length;        // 0 = free
+    uint16_t sequence;
+    uint8_t tries;
+    uint32_t sentTime;      // millis() of the last transmission
+};
+
+/** Fix telemetry over UDP.
+ *  Opening a UDP socket sends nothing over the air, so a device that wakes
+ *  to report skips the TCP handshake and teardown that cost more airtime
+ *  than a few fixes. Fixes are batched with TrackEncoder::encodeBatch,
+ *  TELEMETRY_BATCH_FIXES per datagram:
+ *
+ *      0xB7 0x02 <sequence, 2 bytes big endian> <batch> <xor of batch>
+ *
+ *  With setAckWindow() the server is expected to answer each datagram with
+ *  0xB7 0x82 <sequence>. Unacknowledged datagrams are sent again from
+ *  service() with a doubling timeout, and given up after TELEMETRY_RETRIES.
+ *  When the window is full the oldest datagram is dropped for the new one,
+ *  fresh positions matter more than old ones. Acks are read through
+ *  GPRS::available(), enable GPRS::enableReceiveBuffer() or GPRS::enableMux()
+ *  before begin() so they do not land in the AT stream. When the NMEA stream
+ *  is on, GNSS::readNMEAStream() reads the UART too: forward its other lines
+ *  with GNSS::setURCHandler() to GPRS::handleLine(), otherwise the "+QIRDI"
+ *  of the acks never reaches GPRS and every datagram ends up lost.
+ */
+class UDPTelemetry
+{
+public:
+    /** @param  host  kept by pointer, must stay valid
+     */
+    UDPTelemetry(GPRS &gprs, const char *host, int port);
+
+    /** Open the UDP socket, also done by the first send
+     *  @returns
+     *      true on success
+     *      false on error
+     */
+    bool begin(void);
+
+    /** Send what is batched and close the socket. Datagrams still waiting
+     *  for an ack are forgotten.
+     */
+    void end(void);
+
+    /** Add a fix to the batch, a full batch is sent at once
+     *  @returns
+     *      false if the fix is not valid or the send failed
+     */
+    bool add(const GNSS_Fix &fix);
+
+    /** Send the fixes batched so far as one datagram
+     *  @returns
+     *      true if sent or nothing to send
+     *      false on error (kept for retransmission with an ack window)
+     */
+    bool flush(void);
+
+    /** Read acks and retransmit overdue datagrams, call it from loop() */
+    void service(void);
+
+    /** Datagrams kept until acknowledged, 0 (default) sends and forgets
+     *  @param  window  at most TELEMETRY_WINDOW
+     */
+    void setAckWindow(uint8_t window);
+
+    /** Datagrams sent and not acknowledged yet */
+    uint8_t inFlight(void) const;
+
+    bool isOpen(void) const { return gprs.mux ? gprs.isSocketOpen(socket) : gprs.tcpConnected; }
+
+    /* Statistics */
+    uint32_t datagrams;     // datagrams sent, retransmissions not counted
+    uint32_t bytesSent;     // payload bytes, retransmissions included
+    uint32_t retransmits;
+    uint32_t acked;
+    uint32_t lost;          // given up, pushed out of the window or failed without one
+
+private:
+    bool transmit(const uint8_t *data, size_t length);
+    void receiveAcks(void);
+    void acknowledge(uint16_t sequence);
+    Telemetry_Slot *takeSlot(void);
+
+    GPRS &gprs;
+    const char *host;
+    int port;
+    int socket;             // index with GPRS::mux, -1 otherwise
+    uint8_t window;
+    uint16_t sequence;      // of the next datagram
+
+    TrackEncoder encoder;
+    GNSS_Fix fixes[TELEMETRY_BATCH_FIXES];
+    uint8_t fixCount;
+    uint8_t datagram[TELEMETRY_MAX_DATAGRAM];
+    Telemetry_Slot slots[TELEMETRY_WINDOW];
+
+    uint8_t ack[4];         // ack being parsed
+    uint8_t ackLength;
+};
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ * MC20_TrackCodec.cpp
+ * A library for SeeedStudio GPS Tracker track codec
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "MC20_TrackCodec.h"
+
+/* Round to the nearest multiple of unit, halves away from zero */
+static int32_t quantize(int32_t value, int32_t unit)
+{
+    return value >= 0 ? (value + unit/2) / unit : -((-value + unit/2) / unit);
+}
+
+size_t Track_writeVarint(uint32_t value, uint8_t *out, size_t capacity)
+{
+    size_t len = 0;
+
+    do {
+        if(len >= capacity){
+            return 0;
+        }
+        out[len] = value & 0x7F;
+        value >>= 7;
+        if(value != 0){
+            out[len] |= 0x80;
+        }
+        len++;
+    } while(value != 0);
+
+    return len;
+}
+
+size_t Track_readVarint(const uint8_t *in, size_t length, uint32_t *value)
+{
+    uint32_t result = 0;
+    size_t i;
+
+    for(i = 0; i < length && i < 5; i++){
+        result |= (uint32_t)(in[i] & 0x7F) << (7*i);
+        if(!(in[i] & 0x80)){
+            *value = result;
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+void TrackEncoder::reset(void)
+{
+    time = 0;
+    latitude = 0;
+    longitude = 0;
+    altitude = 0;
+    speed = 0;
+    stepTime = 0;
+    stepLatitude = 0;
+    stepLongitude = 0;
+    absolute = true;
+}
+
+size_t TrackEncoder::encode(const GNSS_Fix &fix, uint8_t *out, size_t capacity)
+{
+    int32_t lat = quantize(fix.latitude, TRACK_COORD_UNIT);
+    int32_t lon = quantize(fix.longitude, TRACK_COORD_UNIT);
+    int32_t alt = quantize(fix.altitude, TRACK_ALT_UNIT);
+    int32_t spd = quantize(fix.speed, TRACK_SPEED_UNIT);
+    uint32_t values[5];
+    size_t len = 0;
+    size_t n;
+
+    int32_t dTime = fix.time - time;
+    int32_t dLat = lat - latitude;
+    int32_t dLon = lon - longitude;
+
+    // Time and position are predicted from the previous step, so a steady
+    // 1 Hz track on a straight road costs little more than a byte per field
+    values[0] = Track_zigzag(dTime - stepTime);
+    values[1] = Track_zigzag(dLat - stepLatitude);
+    values[2] = Track_zigzag(dLon - stepLongitude);
+    values[3] = Track_zigzag(alt - altitude);
+    values[4] = Track_zigzag(spd - speed);
+
+    for(uint8_t i = 0; i < 5; i++){
+        n = Track_writeVarint(values[i], out + len, capacity - len);
+        if(n == 0){
+            return 0;
+        }
+        len += n;
+    }
+
+    time = fix.time;
+    latitude = lat;
+    longitude = lon;
+    altitude = alt;
+    speed = spd;
+    // The absolute record is no step, the next one is predicted as standing still
+    stepTime = absolute ? 0 : dTime;
+    stepLatitude = absolute ? 0 : dLat;
+    stepLongitude = absolute ? 0 : dLon;
+    absolute = false;
+
+    return len;
+}
+
+size_t TrackEncoder::encodeBatch(const GNSS_Fix *fixes, uint16_t count, uint8_t *out, size_t capacity)
+{
+    uint8_t scratch[TRACK_MAX_RECORD];
+    size_t len;
+    size_t n;
+    uint16_t encoded = 0;
+
+    // The count goes first, reserve its worst case (3 bytes) and fix it up after
+    if(capacity < 3){
+        return 0;
+    }
+    reset();
+    len = 3;
+    while(encoded < count){
+        n = encode(fixes[encoded], scratch, sizeof(scratch));
+        if(len + n > capacity){
+            break;
+        }
+        for(size_t i = 0; i < n; i++){
+            out[len + i] = scratch[i];
+        }
+        len += n;
+        encoded++;
+    }
+
+    // Padded varint so the header keeps its reserved 3 bytes
+    out[0] = (encoded & 0x7F) | 0x80;
+    out[1] = ((encoded >> 7) & 0x7F) | 0x80;
+    out[2] = (encoded >> 14) & 0x7F;
+
+    return len;
+}
+
+void TrackDecoder::reset(void)
+{
+    time = 0;
+    latitude = 0;
+    longitude = 0;
+    altitude = 0;
+    speed = 0;
+    stepTime = 0;
+    stepLatitude = 0;
+    stepLongitude = 0;
+    absolute = true;
+}
+
+size_t TrackDecoder::decode(const uint8_t *in, size_t length, GNSS_Fix *fix)
+{
+    uint32_t values[5];
+    size_t len = 0;
+    size_t n;
+
+    for(uint8_t i = 0; i < 5; i++){
+        n = Track_readVarint(in + len, length - len, &values[i]);
+        if(n == 0){
+            return 0;
+        }
+        len += n;
+    }
+
+    stepTime += Track_unzigzag(values[0]);
+    stepLatitude += Track_unzigzag(values[1]);
+    stepLongitude += Track_unzigzag(values[2]);
+    time += stepTime;
+    latitude += stepLatitude;
+    longitude += stepLongitude;
+    altitude += Track_unzigzag(values[3]);
+    speed += Track_unzigzag(values[4]);
+    if(absolute){
+        stepTime = 0;
+        stepLatitude = 0;
+        stepLongitude = 0;
+        absolute = false;
+    }
+
+    *fix = GNSS_Fix();
+    fix->time = time;
+    fix->latitude = latitude * TRACK_COORD_UNIT;
+    fix->longitude = longitude * TRACK_COORD_UNIT;
+    fix->altitude = altitude * TRACK_ALT_UNIT;
+    fix->speed = speed * TRACK_SPEED_UNIT;
+    fix->quality = 1;
+    fix->flags = FIX_HAS_DATE | FIX_VALID;
+
+    return len;
+}
+
+uint16_t TrackDecoder::decodeBatch(const uint8_t *in, size_t length, GNSS_Fix *fixes, uint16_t maxCount)
+{
+    uint32_t count;
+    size_t len;
+    size_t n;
+    uint16_t decoded = 0;
+
+    len = Track_readVarint(in, length, &count);
+    if(len == 0){
+        return 0;
+    }
+    reset();
+    while(decoded < count && decoded < maxCount){
+        n = decode(in + len, length - len, &fixes[decoded]);
+        if(n == 0){
+            break;
+        }
+        len += n;
+        decoded++;
+    }
+
+    return decoded;
+}
@@ -0,0 +1,140 @@
+/*
+ * MC20_TrackCodec.h
+ * A library for SeeedStudio GPS Tracker track codec
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_TRACKCODEC_H__
+#define __MC20_TRACKCODEC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "MC20_NMEA.h"
+
+/* Resolution of the encoded track, fixes are rounded to these units */
+#define TRACK_COORD_UNIT    10      // 1e-7 degrees, 10 = 1e-6 deg (~11 cm)
+#define TRACK_ALT_UNIT      10      // cm, 10 = decimeters
+#define TRACK_SPEED_UNIT    10      // cm/s, 10 = dm/s
+
+/* Worst case bytes of one record: 5 varints of at most 5 bytes */
+#define TRACK_MAX_RECORD    25
+
+/** Compact binary track encoding.
+ *  Each record stores time, latitude, longitude, altitude and speed relative
+ *  to the previous record, zigzag mapped and written as base-128 varints.
+ *  Time and position are coded against a constant velocity prediction
+ *  (the change from the record before), altitude and speed as plain deltas.
+ *  The first record after reset() is relative to zero and the one after it
+ *  a plain delta. A moving point at 1 Hz typically takes 5 - 6 bytes against
+ *  30+ as ASCII text.
+ *
+ *  Only <stdint.h> is needed, so the same file builds on a PC to decode
+ *  uploaded tracks.
+ */
+class TrackEncoder
+{
+public:
+    TrackEncoder() { reset(); }
+
+    /** Forget the previous point, the next record is absolute */
+    void reset(void);
+
+    /** Encode one fix
+     *  @param  out       destination
+     *  @param  capacity  bytes available at out
+     *  @returns
+     *      bytes written, 0 if they did not fit (encoder state unchanged)
+     */
+    size_t encode(const GNSS_Fix &fix, uint8_t *out, size_t capacity);
+
+    /** Encode a self-contained batch: record count, then the records with
+     *  the first one absolute. Fixes that do not fit are left out.
+     *  @returns
+     *      bytes written
+     */
+    size_t encodeBatch(const GNSS_Fix *fixes, uint16_t count, uint8_t *out, size_t capacity);
+
+private:
+    uint32_t time;
+    int32_t latitude;
+    int32_t longitude;
+    int32_t altitude;
+    int32_t speed;
+    int32_t stepTime;       // last differences, used as prediction
+    int32_t stepLatitude;
+    int32_t stepLongitude;
+    bool absolute;          // next record is the first after reset()
+};
+
+class TrackDecoder
+{
+public:
+    TrackDecoder() { reset(); }
+
+    void reset(void);
+
+    /** Decode one record
+     *  @returns
+     *      bytes consumed, 0 if the record is truncated
+     */
+    size_t decode(const uint8_t *in, size_t length, GNSS_Fix *fix);
+
+    /** Decode a batch written by TrackEncoder::encodeBatch
+     *  @param  fixes     destination, at most maxCount fixes
+     *  @returns
+     *      number of fixes decoded
+     */
+    uint16_t decodeBatch(const uint8_t *in, size_t length, GNSS_Fix *fixes, uint16_t maxCount);
+
+private:
+    uint32_t time;
+    int32_t latitude;
+    int32_t longitude;
+    int32_t altitude;
+    int32_t speed;
+    int32_t stepTime;       // last differences, used as prediction
+    int32_t stepLatitude;
+    int32_t stepLongitude;
+    bool absolute;          // next record is the first after reset()
+};
+
+/* Varint helpers, also used by the logger and the telemetry framing */
+size_t Track_writeVarint(uint32_t value, uint8_t *out, size_t capacity);
+size_t Track_readVarint(const uint8_t *in, size_t length, uint32_t *value);
+
+static inline uint32_t Track_zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t Track_unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+#endif
@@ -0,0 +1,303 @@
+/*
+ * MC20_TrackExport.cpp
+ * A library for SeeedStudio GPS Tracker track export
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "MC20_TrackExport.h"
+
+static const char *const headers[] = {
+    // EXPORT_KML
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n"
+    "<Document><Placemark><name>Track</name>\n"
+    "<LineString><tessellate>1</tessellate><coordinates>\n",
+    // EXPORT_GPX
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<gpx version=\"1.1\" creator=\"MC20\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+    "<trk><name>Track</name><trkseg>\n",
+    // EXPORT_GEOJSON
+    "{\"type\":\"Feature\",\"properties\":{\"name\":\"Track\"},\n"
+    "\"geometry\":{\"type\":\"LineString\",\"coordinates\":[\n",
+};
+
+static const char *const footers[] = {
+    "</coordinates></LineString>\n</Placemark></Document>\n</kml>\n",
+    "</trkseg></trk>\n</gpx>\n",
+    "]}}\n",
+};
+
+/* Altitude in cm as meters with 2 decimals */
+static int formatAltitude(char *buffer, int32_t altitude)
+{
+    uint32_t magnitude = altitude < 0 ? -(int64_t)altitude : altitude;
+
+    return sprintf(buffer, "%s%lu.%02lu", altitude < 0 ? "-" : "",
+                   (unsigned long)(magnitude / 100), (unsigned long)(magnitude % 100));
+}
+
+TrackExporter::TrackExporter()
+{
+    format = EXPORT_KML;
+    length = 0;
+    dataEnd = 0;
+    fileEnd = 0;
+    first = true;
+    points = 0;
+    bytesWritten = 0;
+}
+
+char *TrackExporter::formatTime(char *buffer, uint32_t time)
+{
+    // Days to civil date, valid for the whole uint32_t range
+    uint32_t z = time / 86400 + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t day = doy - (153 * mp + 2) / 5 + 1;
+    uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+    uint32_t year = yoe + era * 400 + (month <= 2);
+    uint32_t seconds = time % 86400;
+
+    sprintf(buffer, "%04lu-%02lu-%02luT%02lu:%02lu:%02luZ",
+            (unsigned long)year, (unsigned long)month, (unsigned long)day,
+            (unsigned long)(seconds / 3600), (unsigned long)(seconds / 60 % 60),
+            (unsigned long)(seconds % 60));
+
+    return buffer;
+}
+
+size_t TrackExporter::formatPoint(char *buffer, TrackExport_Format format, const GNSS_Fix &fix, bool first)
+{
+    char latitude[16];
+    char longitude[16];
+    char *p = buffer;
+
+    NMEA_Parser::formatCoordinate(latitude, fix.latitude);
+    NMEA_Parser::formatCoordinate(longitude, fix.longitude);
+
+    switch(format){
+    case EXPORT_GPX:
+        p += sprintf(p, "<trkpt lat=\"%s\" lon=\"%s\"><ele>", latitude, longitude);
+        p += formatAltitude(p, fix.altitude);
+        p += sprintf(p, "</ele>");
+        if(fix.flags & FIX_HAS_DATE){
+            p += sprintf(p, "<time>");
+            formatTime(p, fix.time);
+            p += strlen(p);
+            p += sprintf(p, "</time>");
+        }
+        p += sprintf(p, "</trkpt>\n");
+        break;
+    case EXPORT_GEOJSON:
+        p += sprintf(p, "%s[%s,%s,", first ? "" : ",", longitude, latitude);
+        p += formatAltitude(p, fix.altitude);
+        p += sprintf(p, "]\n");
+        break;
+    default:
+        p += sprintf(p, "%s,%s,", longitude, latitude);
+        p += formatAltitude(p, fix.altitude);
+        p += sprintf(p, "\n");
+        break;
+    }
+
+    return p - buffer;
+}
+
+bool TrackExporter::writeAt(uint32_t position, const char *data, size_t size)
+{
+    if(!file.seek(position)){
+        return false;
+    }
+    if(file.write((const uint8_t *)data, size) != size){
+        return false;
+    }
+    bytesWritten += size;
+
+    return true;
+}
+
+/* Footer at position, then spaces over whatever is left behind it */
+bool TrackExporter::writeFooter(uint32_t position)
+{
+    static const char blank[16] = {
+        ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', '\n'
+    };
+    const char *footer = footers[format];
+    uint32_t end = position + strlen(footer);
+
+    if(!writeAt(position, footer, strlen(footer))){
+        return false;
+    }
+    while(end < fileEnd){
+        size_t n = fileEnd - end < sizeof(blank) ? fileEnd - end : sizeof(blank);
+        if(file.write((const uint8_t *)blank + sizeof(blank) - n, n) != n){
+            return false;
+        }
+        bytesWritten += n;
+        end += n;
+    }
+    fileEnd = end;
+    file.flush();
+
+    return true;
+}
+
+/* Is the '\n' at position the end of a whole point? */
+bool TrackExporter::isPointEnd(uint32_t position)
+{
+    static const char gpxEnd[] = "</trkpt>\n";
+    char tail[sizeof(gpxEnd) - 1];
+    uint32_t start = position + 1 - sizeof(tail);
+
+    if(position + 1 < sizeof(tail)){
+        return false;
+    }
+    file.seek(start);
+    if(file.read(tail, sizeof(tail)) != (int)sizeof(tail)){
+        return false;
+    }
+
+    switch(format){
+    case EXPORT_GPX:
+        return memcmp(tail, gpxEnd, sizeof(tail)) == 0;
+    case EXPORT_GEOJSON:
+        return tail[sizeof(tail) - 2] == ']';
+    default:
+        return tail[sizeof(tail) - 2] >= '0' && tail[sizeof(tail) - 2] <= '9';
+    }
+}
+
+/* Check the header and find the end of the last whole point */
+bool TrackExporter::findEnd(void)
+{
+    const char *header = headers[format];
+    uint32_t headerLength = strlen(header);
+    uint32_t position;
+
+    if(fileEnd < headerLength){
+        return false;
+    }
+    file.seek(0);
+    if(file.read(buffer, headerLength) != (int)headerLength || memcmp(buffer, header, headerLength) != 0){
+        return false;
+    }
+
+    // Backwards one chunk at a time, the footer and blanks are short
+    position = fileEnd;
+    while(position > headerLength){
+        uint32_t start = position - headerLength > sizeof(buffer) ? position - sizeof(buffer) : headerLength;
+        uint16_t n = position - start;
+
+        file.seek(start);
+        if(file.read(buffer, n) != n){
+            return false;
+        }
+        while(n-- > 0){
+            if(buffer[n] == '\n' && isPointEnd(start + n)){
+                dataEnd = start + n + 1;
+                first = false;
+                return true;
+            }
+        }
+        position = start;
+    }
+    dataEnd = headerLength;
+    first = true;
+
+    return true;
+}
+
+bool TrackExporter::begin(const char *name, TrackExport_Format format)
+{
+    this->format = format;
+    length = 0;
+    points = 0;
+    bytesWritten = 0;
+
+    file = SD.open(name, TRACKEXPORT_OPEN_MODE);
+    if(!file){
+        return false;
+    }
+    fileEnd = file.size();
+
+    if(!findEnd()){
+        // Empty or not ours: start a new document over it
+        dataEnd = strlen(headers[format]);
+        first = true;
+        if(!writeAt(0, headers[format], dataEnd)){
+            return false;
+        }
+    }
+    // Also blanks a half written chunk left by a reset
+    return writeFooter(dataEnd);
+}
+
+bool TrackExporter::flush(void)
+{
+    if(!file){
+        return false;
+    }
+    if(length == 0){
+        return true;
+    }
+    if(!writeAt(dataEnd, buffer, length)){
+        return false;
+    }
+    dataEnd += length;
+    length = 0;
+
+    return writeFooter(dataEnd);
+}
+
+bool TrackExporter::add(const GNSS_Fix &fix)
+{
+    if(!file || !(fix.flags & FIX_VALID)){
+        return false;
+    }
+    if((size_t)length + TRACKEXPORT_MAX_POINT > sizeof(buffer) && !flush()){
+        return false;
+    }
+    length += formatPoint(buffer + length, format, fix, first);
+    first = false;
+    points++;
+
+    return true;
+}
+
+void TrackExporter::end(void)
+{
+    if(file){
+        flush();
+        file.close();
+    }
+}
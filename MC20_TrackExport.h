@@ -0,0 +1,123 @@
+/*
+ * MC20_TrackExport.h
+ * A library for SeeedStudio GPS Tracker track export
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_TRACKEXPORT_H__
+#define __MC20_TRACKEXPORT_H__
+
+#include <SD.h>
+#include "MC20_NMEA.h"
+
+#define TRACKEXPORT_CHUNK       256     // bytes of points buffered between writes
+#define TRACKEXPORT_MAX_POINT   128     // longest text of one point, GPX with time
+
+/* FILE_WRITE includes O_APPEND, which would move every write to the end */
+#define TRACKEXPORT_OPEN_MODE   (O_READ | O_WRITE | O_CREAT)
+
+enum TrackExport_Format {
+    EXPORT_KML = 0,
+    EXPORT_GPX,
+    EXPORT_GEOJSON,
+};
+
+/** Streaming track exporter with constant memory.
+ *  The file always holds a complete document: points are buffered and
+ *  every chunk is written over the old footer, followed by the footer
+ *  again. begin() on an existing file finds the end of the last whole
+ *  point and appends from there, so a reset loses at most the buffered
+ *  chunk and never leaves a broken document. Left over bytes past the
+ *  footer (the Arduino SD API can not truncate) are blanked to spaces,
+ *  which XML and JSON both allow after the root element.
+ *
+ *  Each point is one line ending in '\n':
+ *      KML      lon,lat,alt inside one LineString
+ *      GPX      <trkpt> with <ele> and <time> in one <trkseg>
+ *      GeoJSON  [lon,lat,alt] of a LineString Feature
+ */
+class TrackExporter
+{
+public:
+    TrackExporter();
+
+    /** Open or create the document and find where to append
+     *  @returns
+     *      true on success
+     *      false if the file can not be opened or written
+     */
+    bool begin(const char *name, TrackExport_Format format);
+
+    /** Append a fix, only valid fixes are exported
+     *  @returns
+     *      true on success
+     *      false on write error or invalid fix
+     */
+    bool add(const GNSS_Fix &fix);
+
+    /** Write the buffered points and the footer
+     */
+    bool flush(void);
+
+    /** flush() and close the file
+     */
+    void end(void);
+
+    /** Write the text of one point, shared with other text outputs
+     *  @param  buffer  at least TRACKEXPORT_MAX_POINT bytes
+     *  @param  first   no separator before the first GeoJSON point
+     *  @returns
+     *      length of the text
+     */
+    static size_t formatPoint(char *buffer, TrackExport_Format format, const GNSS_Fix &fix, bool first);
+
+    /** ISO 8601 UTC time, "2026-10-18T09:30:00Z"
+     *  @param  buffer  at least 21 bytes
+     */
+    static char *formatTime(char *buffer, uint32_t time);
+
+    /* Statistics */
+    uint32_t points;        // points added since begin()
+    uint32_t bytesWritten;  // bytes written to the card, footers included
+
+private:
+    bool writeAt(uint32_t position, const char *data, size_t size);
+    bool writeFooter(uint32_t position);
+    bool isPointEnd(uint32_t position);
+    bool findEnd(void);
+
+    File file;
+    TrackExport_Format format;
+    char buffer[TRACKEXPORT_CHUNK];
+    uint16_t length;        // bytes in buffer
+    uint32_t dataEnd;       // file offset of the footer
+    uint32_t fileEnd;       // file size, may be past the footer
+    bool first;             // no point in the document yet
+};
+
+#endif
@@ -0,0 +1,363 @@
+/*
+ * MC20_TrackIndex.cpp
+ * A library for SeeedStudio GPS Tracker track index
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "MC20_TrackIndex.h"
+#include "MC20_Geo.h"
+
+#define CELL_BITS       (TRACKINDEX_GEOHASH_BITS / 2)
+#define READ_ENTRIES    8           // entries read at a time by a query
+
+TrackIndex *TrackIndex::active = NULL;
+
+TrackIndex::TrackIndex(TrackLogger &logger) : logger(logger)
+{
+    written = 0;
+    buffered = 0;
+    openCount = 0;
+    openBlock = 0;
+    rebuildBlock = 0;
+    failed = false;
+    entriesRead = 0;
+    blocksRead = 0;
+    callback = NULL;
+}
+
+uint32_t TrackIndex::geohash(int32_t latitude, int32_t longitude)
+{
+    uint32_t latCell = (uint32_t)((((int64_t)latitude + 900000000) << CELL_BITS) / 1800000001LL);
+    uint32_t lonCell = (uint32_t)((((int64_t)longitude + 1800000000) << CELL_BITS) / 3600000001LL);
+    uint32_t hash = 0;
+
+    // Interleave, longitude first as in a geohash string
+    for(int8_t i = CELL_BITS - 1; i >= 0; i--){
+        hash = (hash << 2) | (((lonCell >> i) & 1) << 1) | ((latCell >> i) & 1);
+    }
+    return hash;
+}
+
+void TrackIndex::indexFix(const GNSS_Fix &fix)
+{
+    active->addFix(active->rebuildBlock, fix);
+}
+
+bool TrackIndex::begin(const char *name)
+{
+    TrackIndex_Entry entry;
+    uint32_t blocks = logger.blockCount();
+    uint32_t total, stored;
+    uint32_t last = 0;
+
+    file = SD.open(name, TRACKLOG_OPEN_MODE);
+    if(!file){
+        return false;
+    }
+    failed = false;
+    openCount = 0;
+    openBlock = 0;
+    stored = total = file.size() / sizeof(entry);
+
+    // Drop what is past the log, then the last block: its cells may not all be in
+    while(total > 0){
+        file.seek((total - 1) * sizeof(entry));
+        file.read(&entry, sizeof(entry));
+        if(entry.block != 0 && entry.block <= blocks && (last == 0 || entry.block == last)){
+            last = entry.block;
+        } else if(last != 0){
+            break;
+        }
+        total--;
+    }
+
+    // Zero the dropped entries, a later begin() must not take them for new ones
+    memset(buffer, 0, sizeof(buffer));
+    written = total;
+    while(written < stored){
+        buffered = stored - written < TRACKINDEX_BUFFER ? stored - written : TRACKINDEX_BUFFER;
+        if(!writeEntries()){
+            return false;
+        }
+        written += buffered;
+    }
+
+    written = total - total % TRACKINDEX_BUFFER;
+    buffered = total % TRACKINDEX_BUFFER;
+    file.seek(written * sizeof(entry));
+    file.read(buffer, buffered * sizeof(entry));
+
+    // Index the blocks logged since
+    active = this;
+    for(rebuildBlock = last ? last : 1; rebuildBlock <= blocks; rebuildBlock++){
+        logger.readBlock(rebuildBlock, indexFix);
+    }
+    active = NULL;
+
+    return writeEntries() && !failed;
+}
+
+bool TrackIndex::writeEntries(void)
+{
+    if(!file.seek(written * sizeof(TrackIndex_Entry))){
+        return false;
+    }
+    if(file.write((const uint8_t *)buffer, buffered * sizeof(TrackIndex_Entry)) != buffered * sizeof(TrackIndex_Entry)){
+        return false;
+    }
+    file.flush();
+
+    return true;
+}
+
+bool TrackIndex::emit(const TrackIndex_Entry &entry)
+{
+    buffer[buffered++] = entry;
+    if(buffered == TRACKINDEX_BUFFER){
+        if(!writeEntries()){
+            failed = true;
+            buffered--;
+            return false;
+        }
+        written += TRACKINDEX_BUFFER;
+        buffered = 0;
+    }
+    return true;
+}
+
+bool TrackIndex::closeBlock(void)
+{
+    for(uint8_t i = 0; i < openCount; i++){
+        emit(open[i]);
+    }
+    openCount = 0;
+
+    return !failed;
+}
+
+void TrackIndex::addFix(uint32_t block, const GNSS_Fix &fix)
+{
+    uint32_t hash = geohash(fix.latitude, fix.longitude);
+    uint8_t i;
+
+    if(block != openBlock){
+        closeBlock();
+        openBlock = block;
+    }
+    for(i = 0; i < openCount; i++){
+        if(open[i].geohash == hash){
+            open[i].lastTime = fix.time;
+            return;
+        }
+    }
+    if(openCount == TRACKINDEX_OPEN_CELLS){
+        // Fast through many cells: the oldest one is done
+        emit(open[0]);
+        memmove(&open[0], &open[1], sizeof(open[0]) * (TRACKINDEX_OPEN_CELLS - 1));
+        openCount--;
+    }
+    open[openCount].block = block;
+    open[openCount].geohash = hash;
+    open[openCount].firstTime = fix.time;
+    open[openCount].lastTime = fix.time;
+    openCount++;
+}
+
+bool TrackIndex::log(const GNSS_Fix &fix)
+{
+    if(!file || !logger.log(fix)){
+        return false;
+    }
+    addFix(logger.blockCount(), fix);
+
+    return !failed;
+}
+
+bool TrackIndex::sync(void)
+{
+    if(!file){
+        return false;
+    }
+    // The open entries are not written, begin() rebuilds them from the log
+    return writeEntries() && logger.sync();
+}
+
+void TrackIndex::end(void)
+{
+    if(file){
+        sync();
+        file.close();
+    }
+}
+
+/* Does the cell of the entry overlap the search box and the time window? */
+bool TrackIndex::matchEntry(const TrackIndex_Entry &entry)
+{
+    uint32_t latCell = 0;
+    uint32_t lonCell = 0;
+    int64_t south, west;
+
+    if((queryFrom != 0 && entry.lastTime < queryFrom) || (queryTo != 0 && entry.firstTime > queryTo)){
+        return false;
+    }
+
+    for(int8_t i = CELL_BITS - 1; i >= 0; i--){
+        lonCell = (lonCell << 1) | ((entry.geohash >> (2 * i + 1)) & 1);
+        latCell = (latCell << 1) | ((entry.geohash >> (2 * i)) & 1);
+    }
+    south = ((int64_t)latCell * 1800000000LL >> CELL_BITS) - 900000000;
+    west = ((int64_t)lonCell * 3600000000LL >> CELL_BITS) - 1800000000;
+
+    // Cell size rounded up by one unit, the box is never too small
+    return south <= queryLatitude + queryLatSpan
+        && south + (1800000000LL >> CELL_BITS) + 1 >= queryLatitude - queryLatSpan
+        && west <= queryLongitude + queryLonSpan
+        && west + (3600000000LL >> CELL_BITS) + 1 >= queryLongitude - queryLonSpan;
+}
+
+void TrackIndex::queryFix(const GNSS_Fix &fix)
+{
+    TrackIndex *index = active;
+
+    if((index->queryFrom != 0 && fix.time < index->queryFrom) ||
+       (index->queryTo != 0 && fix.time > index->queryTo)){
+        return;
+    }
+    if(index->radiusSq != 0){
+        int64_t x = ((int64_t)(fix.longitude - index->queryLongitude) * index->lonScale) >> 16;
+        int64_t y = ((int64_t)(fix.latitude - index->queryLatitude) * LAT_SCALE_Q16) >> 16;
+        if(x*x + y*y > index->radiusSq){
+            return;
+        }
+    }
+    index->matches++;
+    if(NULL != index->callback){
+        index->callback(fix);
+    }
+}
+
+uint32_t TrackIndex::readMatching(uint32_t block)
+{
+    blocksRead++;
+    active = this;
+    logger.readBlock(block, queryFix);
+    active = NULL;
+
+    return matches;
+}
+
+uint32_t TrackIndex::findNear(int32_t latitude, int32_t longitude, uint32_t radius,
+                              uint32_t from, uint32_t to, TrackLog_Callback callback)
+{
+    TrackIndex_Entry entries[READ_ENTRIES];
+    uint32_t total = written + buffered;
+    uint32_t lastBlock = 0;
+    int64_t radiusCm = (int64_t)radius * 100;
+
+    entriesRead = 0;
+    blocksRead = 0;
+    matches = 0;
+    if(!file || radius == 0 || !writeEntries()){
+        return 0;
+    }
+
+    this->callback = callback;
+    queryLatitude = latitude;
+    queryLongitude = longitude;
+    queryFrom = from;
+    queryTo = to;
+    radiusSq = radiusCm * radiusCm;
+    // One cosine per query
+    lonScale = Geo_lonScaleQ16(latitude);
+    queryLatSpan = (int32_t)((radiusCm << 16) / LAT_SCALE_Q16);
+    queryLonSpan = (int32_t)((radiusCm << 16) / lonScale);
+
+    // Cells of one block are next to each other, each block is read once
+    for(uint32_t i = 0; i < total; i += READ_ENTRIES){
+        uint8_t n = total - i < READ_ENTRIES ? total - i : READ_ENTRIES;
+        file.seek(i * sizeof(TrackIndex_Entry));
+        if(file.read(entries, n * sizeof(TrackIndex_Entry)) != (int)(n * sizeof(TrackIndex_Entry))){
+            break;
+        }
+        entriesRead += n;
+        for(uint8_t j = 0; j < n; j++){
+            if(entries[j].block != lastBlock && matchEntry(entries[j])){
+                lastBlock = entries[j].block;
+                readMatching(lastBlock);
+            }
+        }
+    }
+    for(uint8_t j = 0; j < openCount; j++){
+        if(open[j].block != lastBlock && matchEntry(open[j])){
+            lastBlock = open[j].block;
+            readMatching(lastBlock);
+        }
+    }
+
+    return matches;
+}
+
+uint32_t TrackIndex::findTime(uint32_t from, uint32_t to, TrackLog_Callback callback)
+{
+    TrackLog_Header header;
+    uint32_t low = 1;
+    uint32_t high = logger.blockCount();
+
+    entriesRead = 0;
+    blocksRead = 0;
+    matches = 0;
+    this->callback = callback;
+    queryFrom = from;
+    queryTo = to;
+    radiusSq = 0;
+
+    // Last block starting at or before from. A block that can not be read,
+    // e.g. the empty one being filled, counts as after so the search does
+    // not settle past the data.
+    while(low < high){
+        uint32_t middle = (low + high + 1) / 2;
+        if(!logger.readHeader(middle, &header) || header.firstTime > from){
+            high = middle - 1;
+        } else {
+            low = middle;
+        }
+    }
+    // low <= blockCount(), the scan starts inside the log
+    for(uint32_t n = low; n <= logger.blockCount(); n++){
+        if(!logger.readHeader(n, &header)){
+            continue;
+        }
+        if(to != 0 && header.firstTime > to){
+            break;
+        }
+        readMatching(n);
+    }
+
+    return matches;
+}
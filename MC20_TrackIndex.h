@@ -0,0 +1,151 @@
+/*
+ * MC20_TrackIndex.h
+ * A library for SeeedStudio GPS Tracker track index
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_TRACKINDEX_H__
+#define __MC20_TRACKINDEX_H__
+
+#include "MC20_TrackLog.h"
+
+#define TRACKINDEX_GEOHASH_BITS     30      // 6 geohash characters, ~1.2 x 0.6 km cells
+#define TRACKINDEX_BUFFER           32      // entries per index write, one SD block
+#define TRACKINDEX_OPEN_CELLS       8       // cells tracked for the block being filled
+
+/* One cell visited during one data block of the log */
+struct TrackIndex_Entry {
+    uint32_t block;         // data block of the TrackLogger file
+    uint32_t geohash;       // TRACKINDEX_GEOHASH_BITS, longitude bit first
+    uint32_t firstTime;     // UTC of the first and last fix in the cell
+    uint32_t lastTime;
+};
+
+/** Sparse spatial index over a TrackLogger file.
+ *  Every data block gets one entry per geohash cell its fixes fall in,
+ *  appended to a second file 32 entries (one SD block) at a time, about
+ *  16 bytes per 100 fixes. findNear() scans the entries and decodes only
+ *  the blocks whose cells overlap the search circle and time window.
+ *  findTime() needs no entries: blocks are in time order and each header
+ *  holds its first time, so it binary searches the log itself.
+ *
+ *  Fixes are logged through log() here instead of TrackLogger::log(),
+ *  begin() re-indexes the blocks logged after the last index write.
+ */
+class TrackIndex
+{
+public:
+    TrackIndex(TrackLogger &logger);
+
+    /** Open or create the index, call after TrackLogger::begin()
+     *  @returns
+     *      true on success
+     *      false if the file can not be opened or written
+     */
+    bool begin(const char *name);
+
+    /** Log a fix to the TrackLogger and index it
+     */
+    bool log(const GNSS_Fix &fix);
+
+    /** Write pending entries and sync the TrackLogger
+     */
+    bool sync(void);
+
+    /** sync() and close the index file
+     */
+    void end(void);
+
+    /** Fixes within radius of a point and in a time window
+     *  @param  latitude   degrees * 1e7
+     *  @param  longitude  degrees * 1e7
+     *  @param  radius     meters
+     *  @param  from       UTC, 0 for no lower limit
+     *  @param  to         UTC, 0 for no upper limit
+     *  @param  callback   called with every matching fix
+     *  @returns
+     *      number of matching fixes
+     */
+    uint32_t findNear(int32_t latitude, int32_t longitude, uint32_t radius,
+                      uint32_t from, uint32_t to, TrackLog_Callback callback);
+
+    /** Fixes in a time window
+     *  @returns
+     *      number of matching fixes
+     */
+    uint32_t findTime(uint32_t from, uint32_t to, TrackLog_Callback callback);
+
+    /** Geohash of a position as an integer, the bits of a 6 character geohash
+     */
+    static uint32_t geohash(int32_t latitude, int32_t longitude);
+
+    /** Entries in the index, including the ones not written yet
+     */
+    uint32_t entryCount(void) const { return written + buffered + openCount; }
+
+    /* Statistics of the last query */
+    uint32_t entriesRead;
+    uint32_t blocksRead;
+
+private:
+    void addFix(uint32_t block, const GNSS_Fix &fix);
+    bool closeBlock(void);
+    bool emit(const TrackIndex_Entry &entry);
+    bool writeEntries(void);
+    bool matchEntry(const TrackIndex_Entry &entry);
+    uint32_t readMatching(uint32_t block);
+    static void indexFix(const GNSS_Fix &fix);
+    static void queryFix(const GNSS_Fix &fix);
+
+    static TrackIndex *active;  // target of the TrackLogger callbacks
+
+    TrackLogger &logger;
+    File file;
+    TrackIndex_Entry buffer[TRACKINDEX_BUFFER];
+    TrackIndex_Entry open[TRACKINDEX_OPEN_CELLS];
+    uint32_t written;       // entries in the file before buffer
+    uint8_t buffered;
+    uint8_t openCount;
+    uint32_t openBlock;     // block of the open entries
+    uint32_t rebuildBlock;  // block being re-indexed by begin()
+    bool failed;            // an entry write failed
+
+    /* Query in progress */
+    TrackLog_Callback callback;
+    int32_t queryLatitude;
+    int32_t queryLongitude;
+    int32_t queryLatSpan;   // half size of the search box, 1e-7 degrees
+    int32_t queryLonSpan;
+    int32_t lonScale;       // cm per 1e-7 degree of longitude, Q16
+    int64_t radiusSq;       // cm^2, 0 for a time only query
+    uint32_t queryFrom;
+    uint32_t queryTo;
+    uint32_t matches;
+};
+
+#endif
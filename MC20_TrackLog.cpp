@@ -0,0 +1,316 @@
+/*
+ * MC20_TrackLog.cpp
+ * A library for SeeedStudio GPS Tracker SD track logging
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "MC20_TrackLog.h"
+#include "MC20_CRC.h"
+
+#define BLOCK_MAGIC     0x4B54          // "TK"
+#define INDEX_MAGIC     0x31474C54UL    // "TLG1"
+#define RECORD_SPACE    (TRACKLOG_BLOCK_SIZE - sizeof(TrackLog_Header))
+
+TrackLogger::TrackLogger()
+{
+    memset(&index, 0, sizeof(index));
+    block = 1;
+    length = 0;
+    count = 0;
+    firstTime = 0;
+    points = 0;
+    bytesLogged = 0;
+    blocksWritten = 0;
+}
+
+bool TrackLogger::writeBlock(uint32_t n, const uint8_t *data)
+{
+    if(!file.seek(n * TRACKLOG_BLOCK_SIZE)){
+        return false;
+    }
+    if(file.write(data, TRACKLOG_BLOCK_SIZE) != TRACKLOG_BLOCK_SIZE){
+        return false;
+    }
+    blocksWritten++;
+
+    return true;
+}
+
+bool TrackLogger::writeIndex(void)
+{
+    uint8_t data[TRACKLOG_BLOCK_SIZE];
+
+    index.points = points;
+    index.crc = MC20_crc16(0xFFFF, (const uint8_t *)&index, sizeof(index) - sizeof(index.crc));
+    memset(data, 0, sizeof(data));
+    memcpy(data, &index, sizeof(index));
+    if(!writeBlock(0, data)){
+        return false;
+    }
+    file.flush();
+
+    return true;
+}
+
+/* Zero-fill the file up front, growing it once instead of with every block */
+bool TrackLogger::preallocate(uint32_t blocks)
+{
+    uint8_t zero[TRACKLOG_BLOCK_SIZE];
+
+    memset(zero, 0, sizeof(zero));
+    if(!file.seek(index.allocated * TRACKLOG_BLOCK_SIZE)){
+        return false;
+    }
+    for(uint32_t i = 0; i < blocks; i++){
+        if(file.write(zero, sizeof(zero)) != sizeof(zero)){
+            return false;
+        }
+    }
+    index.allocated += blocks;
+    file.flush();
+
+    return true;
+}
+
+bool TrackLogger::validBlock(const uint8_t *data, uint32_t n)
+{
+    TrackLog_Header header;
+    uint16_t crc;
+
+    memcpy(&header, data, sizeof(header));
+    if(header.magic != BLOCK_MAGIC || header.sequence != n || header.length > RECORD_SPACE){
+        return false;
+    }
+    crc = header.crc;
+    header.crc = 0;
+    return crc == MC20_crc16(MC20_crc16(0xFFFF, (const uint8_t *)&header, sizeof(header)),
+                        data + sizeof(header), header.length);
+}
+
+bool TrackLogger::begin(const char *name)
+{
+    TrackLog_Header header;
+
+    file = SD.open(name, TRACKLOG_OPEN_MODE);
+    if(!file){
+        return false;
+    }
+    points = 0;
+    length = 0;
+    count = 0;
+    // Every block starts with an absolute record, also after end() and begin()
+    encoder.reset();
+
+    memset(&index, 0, sizeof(index));
+    if(file.size() >= TRACKLOG_BLOCK_SIZE){
+        file.seek(0);
+        file.read(&index, sizeof(index));
+        if(index.magic != INDEX_MAGIC ||
+           index.crc != MC20_crc16(0xFFFF, (const uint8_t *)&index, sizeof(index) - sizeof(index.crc))){
+            // Lost index: rebuild it by scanning from the first block
+            memset(&index, 0, sizeof(index));
+            index.magic = INDEX_MAGIC;
+        }
+        index.allocated = file.size() / TRACKLOG_BLOCK_SIZE;
+        points = index.points;
+
+        // The last indexed block may have filled up since
+        if(index.blocks > 0 && readHeader(index.blocks, &header)){
+            points += header.count - index.lastCount;
+            index.lastCount = header.count;
+        }
+        // Blocks written after the last index update
+        while(index.blocks + 1 < index.allocated && readHeader(index.blocks + 1, &header)){
+            index.blocks++;
+            index.lastCount = header.count;
+            points += header.count;
+        }
+        block = index.blocks + 1;
+        if(block >= index.allocated && !preallocate(TRACKLOG_PREALLOCATE)){
+            return false;
+        }
+        return writeIndex();
+    }
+
+    index.magic = INDEX_MAGIC;
+    index.allocated = 1;
+    block = 1;
+    if(!preallocate(TRACKLOG_PREALLOCATE)){
+        return false;
+    }
+    return writeIndex();
+}
+
+bool TrackLogger::commitBlock(void)
+{
+    TrackLog_Header header;
+
+    header.magic = BLOCK_MAGIC;
+    header.length = length;
+    header.sequence = block;
+    header.firstTime = firstTime;
+    header.count = count;
+    header.crc = 0;
+    memset(buffer + sizeof(header) + length, 0, RECORD_SPACE - length);
+    header.crc = MC20_crc16(MC20_crc16(0xFFFF, (const uint8_t *)&header, sizeof(header)), buffer + sizeof(header), length);
+    memcpy(buffer, &header, sizeof(header));
+
+    return writeBlock(block, buffer);
+}
+
+bool TrackLogger::log(const GNSS_Fix &fix)
+{
+    size_t n;
+
+    if(!file || !(fix.flags & FIX_VALID)){
+        return false;
+    }
+
+    n = encoder.encode(fix, buffer + sizeof(TrackLog_Header) + length, RECORD_SPACE - length);
+    if(n == 0){
+        // Block full: write it whole and start the next one absolute
+        if(!commitBlock()){
+            return false;
+        }
+        index.blocks = block;
+        index.lastCount = count;
+        if(block % TRACKLOG_INDEX_INTERVAL == 0 && !writeIndex()){
+            return false;
+        }
+        block++;
+        length = 0;
+        count = 0;
+        if(block >= index.allocated && !preallocate(TRACKLOG_PREALLOCATE)){
+            return false;
+        }
+        encoder.reset();
+        n = encoder.encode(fix, buffer + sizeof(TrackLog_Header), RECORD_SPACE);
+    }
+    if(count == 0){
+        firstTime = fix.time;
+        if(index.firstTime == 0){
+            index.firstTime = fix.time;
+        }
+    }
+    length += n;
+    count++;
+    points++;
+    index.lastTime = fix.time;
+    bytesLogged += n;
+
+    return true;
+}
+
+bool TrackLogger::sync(void)
+{
+    if(!file){
+        return false;
+    }
+    if(count > 0){
+        if(!commitBlock()){
+            return false;
+        }
+        index.blocks = block;
+        index.lastCount = count;
+    }
+    return writeIndex();
+}
+
+void TrackLogger::end(void)
+{
+    if(file){
+        sync();
+        file.close();
+    }
+}
+
+bool TrackLogger::readHeader(uint32_t n, TrackLog_Header *header)
+{
+    uint8_t data[TRACKLOG_BLOCK_SIZE];
+
+    if(n == block && count > 0){
+        header->magic = BLOCK_MAGIC;
+        header->length = length;
+        header->sequence = block;
+        header->firstTime = firstTime;
+        header->count = count;
+        header->crc = 0;
+        return true;
+    }
+    if(n == 0 || n >= index.allocated || !file.seek(n * TRACKLOG_BLOCK_SIZE)){
+        return false;
+    }
+    if(file.read(data, sizeof(data)) != sizeof(data) || !validBlock(data, n)){
+        return false;
+    }
+    memcpy(header, data, sizeof(*header));
+
+    return true;
+}
+
+uint16_t TrackLogger::readBlock(uint32_t n, TrackLog_Callback callback)
+{
+    uint8_t data[TRACKLOG_BLOCK_SIZE];
+    const uint8_t *records;
+    TrackLog_Header header;
+    TrackDecoder decoder;
+    GNSS_Fix fix;
+    uint16_t decoded = 0;
+    size_t offset = 0;
+    size_t used;
+
+    // The block being filled is read from RAM
+    if(n == block){
+        header.length = length;
+        records = buffer + sizeof(header);
+    } else {
+        if(n == 0 || n >= index.allocated || !file.seek(n * TRACKLOG_BLOCK_SIZE)){
+            return 0;
+        }
+        if(file.read(data, sizeof(data)) != sizeof(data) || !validBlock(data, n)){
+            return 0;
+        }
+        memcpy(&header, data, sizeof(header));
+        records = data + sizeof(header);
+    }
+
+    while(offset < header.length){
+        used = decoder.decode(records + offset, header.length - offset, &fix);
+        if(used == 0){
+            break;
+        }
+        offset += used;
+        decoded++;
+        if(NULL != callback){
+            callback(fix);
+        }
+    }
+
+    return decoded;
+}
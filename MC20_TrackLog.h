@@ -0,0 +1,143 @@
+/*
+ * MC20_TrackLog.h
+ * A library for SeeedStudio GPS Tracker SD track logging
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_TRACKLOG_H__
+#define __MC20_TRACKLOG_H__
+
+#include <SD.h>
+#include "MC20_NMEA.h"
+#include "MC20_TrackCodec.h"
+
+#define TRACKLOG_BLOCK_SIZE         512     // SD block, every write is one whole aligned block
+#define TRACKLOG_PREALLOCATE        2048    // blocks reserved at a time, 1 MB
+#define TRACKLOG_INDEX_INTERVAL     8       // data blocks between index writes
+
+/* FILE_WRITE includes O_APPEND, which would move every write to the end */
+#define TRACKLOG_OPEN_MODE          (O_READ | O_WRITE | O_CREAT)
+
+/* Start of every data block, the records follow */
+struct TrackLog_Header {
+    uint16_t magic;
+    uint16_t length;        // bytes of records
+    uint32_t sequence;      // block number in the file, data starts at 1
+    uint32_t firstTime;     // UTC of the first fix in the block
+    uint16_t count;         // fixes in the block
+    uint16_t crc;           // CRC-16 of header and records, crc field as 0
+};
+
+/* Block 0 of the file */
+struct TrackLog_Index {
+    uint32_t magic;
+    uint32_t blocks;        // data blocks written, the last one may be partial
+    uint32_t allocated;     // blocks in the file, index included
+    uint32_t points;
+    uint32_t firstTime;
+    uint32_t lastTime;
+    uint16_t lastCount;     // fixes in block "blocks" when the index was written
+    uint16_t crc;
+};
+
+typedef void (*TrackLog_Callback)(const GNSS_Fix &fix);
+
+/** Append-only track log on the SD card.
+ *  Fixes are encoded with TrackEncoder into a 512 byte buffer that is
+ *  written as one aligned block when full, into a file preallocated in
+ *  1 MB steps so a block write never touches the FAT or the directory.
+ *  Each block starts with an absolute record and decodes on its own.
+ *  The index in block 0 is rewritten every TRACKLOG_INDEX_INTERVAL blocks,
+ *  after a reset begin() scans on from it for blocks written since.
+ */
+class TrackLogger
+{
+public:
+    TrackLogger();
+
+    /** Open or create the log and recover its end
+     *  @returns
+     *      true on success
+     *      false if the file can not be opened or preallocated
+     */
+    bool begin(const char *name);
+
+    /** Append a fix, only valid fixes are logged
+     *  @returns
+     *      true on success
+     *      false on write error or invalid fix
+     */
+    bool log(const GNSS_Fix &fix);
+
+    /** Write the partial block and the index, e.g. before sleeping.
+     *  The block is rewritten in place as it fills up.
+     */
+    bool sync(void);
+
+    /** sync() and close the file
+     */
+    void end(void);
+
+    /** Data blocks in the log, the one being filled included
+     */
+    uint32_t blockCount(void) const { return block; }
+
+    /** Read the header of data block n, 1 - blockCount()
+     */
+    bool readHeader(uint32_t n, TrackLog_Header *header);
+
+    /** Decode data block n, 1 - blockCount(), fixes go to callback
+     *  @returns
+     *      fixes decoded
+     */
+    uint16_t readBlock(uint32_t n, TrackLog_Callback callback);
+
+    /* Statistics */
+    uint32_t points;        // fixes in the log
+    uint32_t bytesLogged;   // encoded record bytes
+    uint32_t blocksWritten; // card blocks written, index and syncs included,
+                            // preallocation not
+
+private:
+    bool writeBlock(uint32_t n, const uint8_t *data);
+    bool commitBlock(void);
+    bool writeIndex(void);
+    bool preallocate(uint32_t blocks);
+    bool validBlock(const uint8_t *data, uint32_t n);
+
+    File file;
+    uint8_t buffer[TRACKLOG_BLOCK_SIZE] __attribute__((__aligned__(4)));
+    TrackLog_Index index;
+    TrackEncoder encoder;
+    uint32_t block;         // data block being filled
+    uint16_t length;        // record bytes in buffer
+    uint16_t count;         // fixes in buffer
+    uint32_t firstTime;
+};
+
+#endif
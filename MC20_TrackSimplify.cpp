@@ -0,0 +1,176 @@
+/*
+ * MC20_TrackSimplify.cpp
+ * A library for SeeedStudio GPS Tracker track simplification
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "MC20_TrackSimplify.h"
+#include "MC20_Geo.h"
+
+TrackSimplifier::TrackSimplifier(uint16_t tolerance, uint16_t gap)
+{
+    setTolerance(tolerance);
+    maxGap = gap;
+    kept = 0;
+    dropped = 0;
+    reset();
+}
+
+void TrackSimplifier::setTolerance(uint16_t meters)
+{
+    toleranceCm = meters * 100UL;
+}
+
+void TrackSimplifier::reset(void)
+{
+    haveAnchor = false;
+    windowCount = 0;
+}
+
+uint8_t TrackSimplifier::keptPercent(void) const
+{
+    if(kept + dropped == 0){
+        return 100;
+    }
+    return (uint8_t)((uint64_t)kept * 100 / (kept + dropped));
+}
+
+void TrackSimplifier::setAnchor(const GNSS_Fix &fix)
+{
+    anchor = fix;
+    // One cosine per kept point, not per fix
+    lonScale = Geo_lonScaleQ16(fix.latitude);
+    haveAnchor = true;
+    windowCount = 0;
+}
+
+void TrackSimplifier::project(const GNSS_Fix &fix, int32_t *x, int32_t *y) const
+{
+    *x = (int32_t)(((int64_t)(fix.longitude - anchor.longitude) * lonScale) >> 16);
+    *y = (int32_t)(((int64_t)(fix.latitude - anchor.latitude) * LAT_SCALE_Q16) >> 16);
+}
+
+/* Every window point within tolerance of the segment anchor -> (px, py)? */
+bool TrackSimplifier::withinTolerance(int32_t px, int32_t py) const
+{
+    int64_t lengthSq = (int64_t)px*px + (int64_t)py*py;
+    int64_t toleranceSq = (int64_t)toleranceCm * toleranceCm;
+    int64_t length = Geo_isqrt64(lengthSq);
+
+    for(uint8_t i = 0; i < windowCount; i++){
+        int64_t qx = windowX[i];
+        int64_t qy = windowY[i];
+        int64_t dot = qx*px + qy*py;
+
+        if(dot <= 0 || lengthSq == 0){
+            // Behind the anchor: distance to the anchor
+            if(qx*qx + qy*qy > toleranceSq){
+                return false;
+            }
+        } else if(dot >= lengthSq){
+            // Past the end point: distance to the end point
+            if((qx - px)*(qx - px) + (qy - py)*(qy - py) > toleranceSq){
+                return false;
+            }
+        } else {
+            // |cross| / |P| is the distance to the line
+            int64_t cross = px*qy - py*qx;
+            if(cross < 0){
+                cross = -cross;
+            }
+            if(cross > (int64_t)toleranceCm * length){
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TrackSimplifier::add(const GNSS_Fix &fix, GNSS_Fix *out)
+{
+    int32_t x, y;
+
+    if(!(fix.flags & FIX_VALID)){
+        return false;
+    }
+
+    // First point of a track is always kept
+    if(!haveAnchor){
+        setAnchor(fix);
+        *out = fix;
+        kept++;
+        return true;
+    }
+
+    project(fix, &x, &y);
+    if(windowCount < TRACK_SIMPLIFY_WINDOW && withinTolerance(x, y)
+       && (maxGap == 0 || fix.time - anchor.time <= maxGap)){
+        // Still straight enough, the previous end point is dropped
+        if(windowCount > 0){
+            dropped++;
+        }
+        windowX[windowCount] = x;
+        windowY[windowCount] = y;
+        windowCount++;
+        last = fix;
+        return false;
+    }
+
+    if(windowCount == 0){
+        // maxGap already passed since the anchor, keep this one
+        setAnchor(fix);
+        *out = fix;
+        kept++;
+        return true;
+    }
+
+    // The previous point ends the segment, this one opens the next window
+    *out = last;
+    kept++;
+    setAnchor(last);
+    project(fix, &x, &y);
+    windowX[0] = x;
+    windowY[0] = y;
+    windowCount = 1;
+    last = fix;
+
+    return true;
+}
+
+bool TrackSimplifier::flush(GNSS_Fix *out)
+{
+    if(windowCount == 0){
+        return false;
+    }
+    *out = last;
+    kept++;
+    setAnchor(last);
+
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * MC20_TrackSimplify.h
+ * A library for SeeedStudio GPS Tracker track simplification
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_TRACKSIMPLIFY_H__
+#define __MC20_TRACKSIMPLIFY_H__
+
+#include <stdint.h>
+#include "MC20_NMEA.h"
+
+/* Points held back at most before one is forced out, bounds memory and delay */
+#ifndef TRACK_SIMPLIFY_WINDOW
+#define TRACK_SIMPLIFY_WINDOW   32
+#endif
+
+/** Online line simplification of the fix stream (opening window).
+ *  The last kept point is the anchor. A new point is accepted as the end of
+ *  a straight segment from the anchor as long as every point in between
+ *  stays within the tolerance of that segment; when it does not, the
+ *  previous point is kept and becomes the new anchor. Straight roads
+ *  collapse to their corners, so what is stored and sent grows with path
+ *  complexity instead of time.
+ *
+ *      GNSS_Fix kept;
+ *      if(simplifier.add(gnss.fix, &kept)){
+ *          // store or send kept
+ *      }
+ */
+class TrackSimplifier
+{
+public:
+    /** @param  tolerance  cross-track tolerance in meters
+     *  @param  maxGap     seconds after which a point is kept anyway, 0 = never
+     */
+    TrackSimplifier(uint16_t tolerance = 5, uint16_t maxGap = 0);
+
+    void setTolerance(uint16_t meters);
+    void setMaxGap(uint16_t seconds) { maxGap = seconds; }
+
+    /** Start a new track, counters are kept */
+    void reset(void);
+
+    /** Feed the next fix, invalid fixes are ignored
+     *  @param  kept  receives the point to keep when true is returned
+     *  @returns
+     *      true if a point has to be kept
+     *      false if the fix was absorbed (so far)
+     */
+    bool add(const GNSS_Fix &fix, GNSS_Fix *kept);
+
+    /** Release the pending end point, e.g. before an upload or sleep
+     *  @returns
+     *      true if there was one
+     */
+    bool flush(GNSS_Fix *kept);
+
+    uint32_t keptCount(void) const { return kept; }
+    uint32_t droppedCount(void) const { return dropped; }
+
+    /** Kept points in percent of the points fed */
+    uint8_t keptPercent(void) const;
+
+private:
+    void setAnchor(const GNSS_Fix &fix);
+    void project(const GNSS_Fix &fix, int32_t *x, int32_t *y) const;
+    bool withinTolerance(int32_t px, int32_t py) const;
+
+    uint32_t toleranceCm;
+    uint16_t maxGap;
+
+    GNSS_Fix anchor;
+    int32_t lonScale;       // cm per 1e-7 degree longitude at the anchor, Q16
+    bool haveAnchor;
+
+    GNSS_Fix last;          // pending end point
+    int32_t windowX[TRACK_SIMPLIFY_WINDOW];     // cm east of the anchor
+    int32_t windowY[TRACK_SIMPLIFY_WINDOW];     // cm north of the anchor
+    uint8_t windowCount;
+
+    uint32_t kept;
+    uint32_t dropped;
+};
+
+#endif
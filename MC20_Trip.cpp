@@ -0,0 +1,177 @@
+/*
+ * MC20_Trip.cpp
+ * A library for SeeedStudio GPS Tracker trip statistics
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "MC20_Trip.h"
+#include "MC20_Geo.h"
+
+/* GNSS_TripData::flags */
+#define TRIP_STARTED        0x01    // lastTime is set
+#define TRIP_ANCHOR         0x02    // anchor position is set
+#define TRIP_MOVING         0x04
+#define TRIP_STOP_PENDING   0x08    // slowed down, not still for long enough yet
+
+GNSS_Trip::GNSS_Trip()
+{
+    memset(&data, 0, sizeof(data));
+    setThresholds(TRIP_JITTER_MIN, TRIP_JITTER_PER_HDOP, TRIP_MAX_HDOP,
+                  TRIP_MOVE_SPEED, TRIP_STOP_SPEED, TRIP_STOP_TIME);
+    lonScale = 0;
+    scaleLatitude = 0;
+}
+
+void GNSS_Trip::reset(void)
+{
+    uint32_t odometer = data.odometer;
+
+    memset(&data, 0, sizeof(data));
+    data.odometer = odometer;
+}
+
+void GNSS_Trip::setThresholds(uint16_t jitterMin, uint16_t jitterPerHdop, uint16_t maxHdop,
+                              uint16_t moveSpeed, uint16_t stopSpeed, uint16_t stopTime)
+{
+    this->jitterMin = jitterMin;
+    this->jitterPerHdop = jitterPerHdop;
+    this->maxHdop = maxHdop;
+    this->moveSpeed = moveSpeed;
+    this->stopSpeed = stopSpeed;
+    this->stopTime = stopTime;
+}
+
+bool GNSS_Trip::isMoving(void) const
+{
+    return data.flags & TRIP_MOVING;
+}
+
+uint16_t GNSS_Trip::averageSpeed(void) const
+{
+    if(data.movingTime == 0){
+        return 0;
+    }
+    return (uint16_t)(((uint64_t)data.meters * 100 + data.centimeters) / data.movingTime);
+}
+
+void GNSS_Trip::addDistance(uint32_t cm)
+{
+    cm += data.centimeters;
+    data.meters += cm / 100;
+    data.odometer += cm / 100;
+    data.centimeters = cm % 100;
+}
+
+bool GNSS_Trip::update(const GNSS_Fix &fix)
+{
+    uint32_t dt;
+    int64_t dx, dy, squared, jitter;
+
+    if(!(fix.flags & FIX_VALID)){
+        return false;
+    }
+
+    // Time: gaps longer than TRIP_MAX_GAP (sleep, no fix) are not counted
+    if(!(data.flags & TRIP_STARTED)){
+        data.startTime = fix.time;
+        data.flags |= TRIP_STARTED;
+        dt = 0;
+    } else {
+        dt = fix.time - data.lastTime;
+        if(dt > TRIP_MAX_GAP || fix.time < data.lastTime){
+            dt = 0;
+        }
+    }
+    data.lastTime = fix.time;
+
+    // Moving / still with hysteresis, a stop needs stopTime seconds of still
+    if(fix.speed >= moveSpeed){
+        data.flags |= TRIP_MOVING;
+        data.flags &= ~TRIP_STOP_PENDING;
+    } else if(fix.speed < stopSpeed && (data.flags & TRIP_MOVING)){
+        data.flags &= ~TRIP_MOVING;
+        data.flags |= TRIP_STOP_PENDING;
+        data.stillSince = fix.time;
+    }
+    if((data.flags & TRIP_STOP_PENDING) && fix.time - data.stillSince >= stopTime){
+        data.flags &= ~TRIP_STOP_PENDING;
+        data.stops++;
+    }
+    if(data.flags & TRIP_MOVING){
+        data.movingTime += dt;
+    } else {
+        data.idleTime += dt;
+    }
+
+    if(fix.hdop > maxHdop){
+        return false;
+    }
+    if(fix.speed > data.maxSpeed){
+        data.maxSpeed = fix.speed;
+    }
+
+    if(!(data.flags & TRIP_ANCHOR)){
+        data.anchorLatitude = fix.latitude;
+        data.anchorLongitude = fix.longitude;
+        data.flags |= TRIP_ANCHOR;
+        return false;
+    }
+
+    Geo_updateLonScale(fix.latitude, &lonScale, &scaleLatitude);
+
+    // Distance to the last counted point, only counted outside the jitter radius
+    dy = ((int64_t)(fix.latitude - data.anchorLatitude) * LAT_SCALE_Q16) >> 16;
+    dx = ((int64_t)(fix.longitude - data.anchorLongitude) * lonScale) >> 16;
+    squared = dx*dx + dy*dy;
+    jitter = jitterMin + (int64_t)fix.hdop * jitterPerHdop / 100;
+    if(squared <= jitter*jitter){
+        return false;
+    }
+
+    addDistance(Geo_isqrt64(squared));
+    data.anchorLatitude = fix.latitude;
+    data.anchorLongitude = fix.longitude;
+
+    return true;
+}
+
+void GNSS_Trip::setData(const GNSS_TripData &saved)
+{
+    data = saved;
+}
+
+bool GNSS_Trip::save(FlashStore &store) const
+{
+    return store.write(&data, sizeof(data));
+}
+
+bool GNSS_Trip::load(FlashStore &store)
+{
+    return store.read(&data, sizeof(data));
+}
@@ -0,0 +1,127 @@
+/*
+ * MC20_Trip.h
+ * A library for SeeedStudio GPS Tracker trip statistics
+ *
+ * Copyright (c) 2017 seeed technology inc.
+ * Website    : www.seeed.cc
+ * Author     : lawliet zou, lambor
+ * Create Time: October 2026
+ * Change Log :
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __MC20_TRIP_H__
+#define __MC20_TRIP_H__
+
+#include <stdint.h>
+#include "MC20_NMEA.h"
+#include "MC20_FlashStore.h"
+
+/* Defaults, see GNSS_Trip::setThresholds() */
+#define TRIP_JITTER_MIN         500     // cm, smallest step that counts as distance
+#define TRIP_JITTER_PER_HDOP    500     // cm added per 1.0 HDOP
+#define TRIP_MAX_HDOP           500     // HDOP * 100, worse fixes add no distance
+#define TRIP_MOVE_SPEED         150     // cm/s to start moving
+#define TRIP_STOP_SPEED         50      // cm/s to stop moving
+#define TRIP_STOP_TIME          60      // seconds still before it counts as a stop
+#define TRIP_MAX_GAP            60      // seconds between fixes counted as time
+
+/* Everything the trip needs to carry on, 44 bytes so it fits a FlashStore page */
+struct GNSS_TripData {
+    uint32_t odometer;      // meters, survives reset()
+    uint32_t meters;        // trip distance
+    uint16_t centimeters;   // remainder of the trip distance
+    uint16_t maxSpeed;      // cm/s
+    uint32_t movingTime;    // seconds
+    uint32_t idleTime;      // seconds
+    uint32_t startTime;     // UTC of the first fix
+    uint32_t lastTime;      // UTC of the last fix
+    uint32_t stillSince;    // UTC when speed dropped below the stop speed
+    int32_t  anchorLatitude;    // last point distance was counted to
+    int32_t  anchorLongitude;
+    uint16_t stops;
+    uint8_t  flags;
+    uint8_t  reserved;
+};
+
+/** Trip accumulator on the fix stream.
+ *  update() is O(1) integer work per fix, the totals are read in O(1).
+ *  Distance is only counted once the position moved further from the last
+ *  counted point than the jitter radius, so a parked tracker stays at 0.
+ */
+class GNSS_Trip
+{
+public:
+    GNSS_Trip();
+
+    /** Start a new trip, the odometer keeps counting
+     */
+    void reset(void);
+
+    void setThresholds(uint16_t jitterMin, uint16_t jitterPerHdop, uint16_t maxHdop,
+                       uint16_t moveSpeed, uint16_t stopSpeed, uint16_t stopTime);
+
+    /** Account one fix
+     *  @returns
+     *      true if the fix added distance
+     */
+    bool update(const GNSS_Fix &fix);
+
+    uint32_t distance(void) const { return data.meters; }          // meters
+    uint32_t odometer(void) const { return data.odometer; }        // meters
+    uint32_t movingTime(void) const { return data.movingTime; }    // seconds
+    uint32_t idleTime(void) const { return data.idleTime; }        // seconds
+    uint16_t maxSpeed(void) const { return data.maxSpeed; }        // cm/s
+    uint16_t stops(void) const { return data.stops; }
+    bool isMoving(void) const;
+
+    /** Average speed while moving, cm/s
+     */
+    uint16_t averageSpeed(void) const;
+
+    /** Raw state, to keep in RAM retained over sleep or anywhere else
+     */
+    const GNSS_TripData &getData(void) const { return data; }
+    void setData(const GNSS_TripData &saved);
+
+    /** Keep the state in / restore it from flash
+     */
+    bool save(FlashStore &store) const;
+    bool load(FlashStore &store);
+
+private:
+    void addDistance(uint32_t cm);
+
+    GNSS_TripData data;
+
+    uint16_t jitterMin;
+    uint16_t jitterPerHdop;
+    uint16_t maxHdop;
+    uint16_t moveSpeed;
+    uint16_t stopSpeed;
+    uint16_t stopTime;
+
+    int32_t lonScale;           // cm per 1e-7 degree longitude, Q16
+    int32_t scaleLatitude;      // latitude lonScale was computed for
+};
+
+#endif
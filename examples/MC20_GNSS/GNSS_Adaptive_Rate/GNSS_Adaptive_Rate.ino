@@ -0,0 +1,51 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_RateControl.h"
+
+
+GNSS gnss = GNSS();
+GNSS_RateController rate = GNSS_RateController();
+unsigned long lastPoll = 0;
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.enableNMEAStream(true);
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+  gnss.setFixInterval(rate.fixInterval());
+}
+
+void loop() {
+  // Drain the stream on every pass, a slower level lowers the fix interval
+  // instead, so the Serial1 buffer never overflows
+  if(gnss.readNMEAStream() && rate.update(gnss.fix)){
+    SerialUSB.print("Speed(cm/s): ");
+    SerialUSB.print(gnss.fix.speed);
+    SerialUSB.print(" -> level ");
+    SerialUSB.print(rate.getLevel());
+    SerialUSB.print(", fix interval(ms): ");
+    SerialUSB.println(rate.fixInterval());
+    gnss.setFixInterval(rate.fixInterval());
+  }
+
+  // Only the application work follows the poll period
+  if((unsigned long)(millis() - lastPoll) < rate.pollPeriod()){
+    return;
+  }
+  lastPoll = millis();
+
+  SerialUSB.print("Position: ");
+  SerialUSB.print(gnss.str_latitude);
+  SerialUSB.print(", ");
+  SerialUSB.println(gnss.str_longitude);
+}
@@ -0,0 +1,62 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+
+/* Duty-cycled GNSS with EPO. EPO is only downloaded when the loaded data
+ * is about to run out, and TTFF is reported with and without it.
+ */
+
+#define OFF_MINUTES   15
+#define FIX_TIMEOUT   300     // seconds to wait for a fix
+
+GNSS gnss = GNSS();
+
+void printTTFF(const char *name, const GNSS_TTFF &stats)
+{
+  SerialUSB.print(name);
+  SerialUSB.print(" starts: ");
+  SerialUSB.print(stats.count);
+  if(stats.count > 0){
+    SerialUSB.print(", TTFF avg/best/worst ms: ");
+    SerialUSB.print(stats.total / stats.count);
+    SerialUSB.print("/");
+    SerialUSB.print(stats.best);
+    SerialUSB.print("/");
+    SerialUSB.print(stats.worst);
+  }
+  SerialUSB.println();
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  gnss.setEPOValidity(EPO_VALIDITY, EPO_REFRESH_MARGIN);
+  gnss.enableNMEAStream(true);
+}
+
+void loop() {
+  unsigned long start = millis();
+
+  if(!gnss.open_GNSS(EPO_QUICK_MODE)){
+    SerialUSB.println("Open GNSS failed.");
+  }
+  while(gnss.lastTTFF == 0 || !(gnss.fix.flags & FIX_VALID)){
+    gnss.readNMEAStream();
+    if(millis() - start > FIX_TIMEOUT * 1000UL){
+      break;
+    }
+  }
+
+  SerialUSB.print("EPO valid: ");
+  SerialUSB.println(gnss.isEPOValid() ? "yes" : "no");
+  printTTFF("Fresh EPO", gnss.ttffFreshEPO);
+  printTTFF("No EPO", gnss.ttffNoEPO);
+
+  gnss.close_GNSS();
+  gnss.lastTTFF = 0;
+  delay(OFF_MINUTES * 60000UL);
+}
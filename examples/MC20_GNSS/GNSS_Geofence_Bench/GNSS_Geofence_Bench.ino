@@ -0,0 +1,130 @@
+#include "MC20_Geofence.h"
+
+/* Per-fix geofence cost at 10 / 100 / 1000 fences, grid index against a
+ * single cell (every fence tested on every fix). No modem needed, fences
+ * and the track are generated around a fixed point.
+ */
+
+#define MAX_FENCES      1000
+#define MAX_POLYGONS    50          // every 20th fence is a 4 vertex polygon
+#define MAX_ENTRIES     2500
+#define GRID_SIZE       16
+#define TRACK_FIXES     500
+
+#define CENTER_LAT      225840000L  // degrees * 1e7
+#define CENTER_LON      1139660000L
+#define AREA            1000000L    // fences spread over +-0.1 degree
+
+Geofence fences[MAX_FENCES];
+Geofence_Point vertices[MAX_POLYGONS * 4];
+uint16_t cellStart[GRID_SIZE * GRID_SIZE + 1];
+uint16_t cellFences[MAX_ENTRIES];
+uint8_t state[MAX_FENCES];
+uint32_t events;
+
+void onEvent(uint16_t id, bool entered, const GNSS_Fix &fix)
+{
+  events++;
+}
+
+uint16_t generateFences(uint16_t count)
+{
+  uint16_t polygons = 0;
+
+  randomSeed(1);
+  for(uint16_t i = 0; i < count; i++){
+    int32_t lat = CENTER_LAT + random(-AREA, AREA);
+    int32_t lon = CENTER_LON + random(-AREA, AREA);
+    int32_t half = random(500, 3000);   // 1e-7 degree, roughly 55 - 330 m
+
+    fences[i].id = i;
+    if(i % 20 == 19 && polygons < MAX_POLYGONS){
+      Geofence_Point *v = &vertices[polygons * 4];
+      v[0].latitude = lat - half;  v[0].longitude = lon - half;
+      v[1].latitude = lat - half;  v[1].longitude = lon + half;
+      v[2].latitude = lat + half;  v[2].longitude = lon;
+      v[3].latitude = lat;         v[3].longitude = lon - half;
+      fences[i].type = GEOFENCE_POLYGON;
+      fences[i].vertexCount = 4;
+      fences[i].data = polygons * 4;
+      polygons++;
+    } else {
+      fences[i].type = GEOFENCE_CIRCLE;
+      fences[i].latitude = lat;
+      fences[i].longitude = lon;
+      fences[i].data = half * 11;       // cm
+    }
+  }
+  return count;
+}
+
+void runTrack(GeofenceEngine &engine)
+{
+  GNSS_Fix fix;
+
+  memset(&fix, 0, sizeof(fix));
+  fix.flags = FIX_VALID;
+  for(uint16_t i = 0; i < TRACK_FIXES; i++){
+    // Diagonal across the area with a wobble
+    fix.time = i;
+    fix.latitude = CENTER_LAT - AREA + (int32_t)i * (2 * AREA / TRACK_FIXES);
+    fix.longitude = CENTER_LON - AREA + (int32_t)i * (2 * AREA / TRACK_FIXES) + (i % 40) * 2000;
+    engine.update(fix);
+  }
+}
+
+void bench(uint16_t count, uint8_t gridSize)
+{
+  Geofence_Grid grid;
+  uint32_t start, elapsed, entries;
+
+  generateFences(count);
+  start = micros();
+  entries = GeofenceEngine::buildIndex(fences, count, vertices, gridSize, gridSize,
+                                       cellStart, cellFences, MAX_ENTRIES, &grid);
+  elapsed = micros() - start;
+  if(entries == 0){
+    SerialUSB.println("Index does not fit, raise MAX_ENTRIES");
+    return;
+  }
+
+  GeofenceEngine engine(fences, count, vertices, &grid, state);
+  engine.setCallback(onEvent);
+  events = 0;
+
+  start = micros();
+  runTrack(engine);
+  uint32_t perFix = (micros() - start) / TRACK_FIXES;
+
+  SerialUSB.print(count);
+  SerialUSB.print(",");
+  SerialUSB.print(gridSize);
+  SerialUSB.print("x");
+  SerialUSB.print(gridSize);
+  SerialUSB.print(",");
+  SerialUSB.print(entries);
+  SerialUSB.print(",");
+  SerialUSB.print(elapsed);
+  SerialUSB.print(",");
+  SerialUSB.print(perFix);
+  SerialUSB.print(",");
+  SerialUSB.print(engine.tested / TRACK_FIXES);
+  SerialUSB.print(",");
+  SerialUSB.println(events);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  while(!SerialUSB);
+
+  SerialUSB.println("fences,grid,entries,build_us,us_per_fix,tests_per_fix,events");
+  bench(10, GRID_SIZE);
+  bench(10, 1);
+  bench(100, GRID_SIZE);
+  bench(100, 1);
+  bench(1000, GRID_SIZE);
+  bench(1000, 1);
+}
+
+void loop() {
+}
@@ -0,0 +1,95 @@
+/********************************************************************************************
+ Replays a recorded NMEA log from the SD card through the parser and the Kalman filter and
+ reports the CPU cost per update and how far the filtered track is from the raw one.
+ Any raw NMEA capture works (one sentence per line); name it nmea.txt.
+*********************************************************************************************/
+
+#include <SPI.h>
+#include <SD.h>
+#include "MC20_NMEA.h"
+#include "MC20_Kalman.h"
+
+const int chipSelect = 4;
+char* nmeaFileName = "nmea.txt";
+
+NMEA_Parser nmea = NMEA_Parser();
+GNSS_Kalman kalman = GNSS_Kalman();
+
+// cm between two fixes, flat earth is fine for consecutive points
+uint32_t distance(const GNSS_Fix &a, const GNSS_Fix &b)
+{
+  double dy = (b.latitude - a.latitude) * 1.11195;
+  double dx = (b.longitude - a.longitude) * 1.11195 * cos(a.latitude * 1e-7 * PI / 180.0);
+  return sqrt(dx*dx + dy*dy);
+}
+
+void setup() {
+  File nmeaFile;
+  GNSS_Fix raw, filtered, lastRaw, lastFiltered;
+  uint32_t fixes = 0;
+  uint32_t updateMicros = 0;
+  uint32_t rawLength = 0;
+  uint32_t filteredLength = 0;
+  double squaredError = 0;
+  unsigned long timerStart;
+
+  pinMode(12, OUTPUT);
+  digitalWrite(12, HIGH);
+  SerialUSB.begin(115200);
+  while(!SerialUSB);
+
+  if(!SD.begin(chipSelect)){
+    SerialUSB.println("SD initialization failed!");
+    return;
+  }
+  nmeaFile = SD.open(nmeaFileName);
+  if(!nmeaFile){
+    SerialUSB.println("No nmea.txt on the card.");
+    return;
+  }
+
+  while(nmeaFile.available()){
+    if(!nmea.feed((char)nmeaFile.read())){
+      continue;
+    }
+    raw = nmea.getFix();
+    if(!(raw.flags & FIX_VALID)){
+      continue;
+    }
+
+    // Logged time stands in for millis()
+    timerStart = micros();
+    kalman.updateFix(raw, raw.time * 1000UL + raw.msec);
+    kalman.getEstimate(&filtered);
+    updateMicros += micros() - timerStart;
+
+    if(fixes > 0){
+      rawLength += distance(lastRaw, raw);
+      filteredLength += distance(lastFiltered, filtered);
+    }
+    squaredError += (double)distance(raw, filtered) * distance(raw, filtered);
+    lastRaw = raw;
+    lastFiltered = filtered;
+    fixes++;
+  }
+  nmeaFile.close();
+
+  SerialUSB.print("Fixes: ");
+  SerialUSB.println(fixes);
+  if(fixes == 0){
+    return;
+  }
+  SerialUSB.print("Update cost (us): ");
+  SerialUSB.println(updateMicros / fixes);
+  SerialUSB.print("Rejected by gate: ");
+  SerialUSB.println(kalman.rejected);
+  SerialUSB.print("RMS raw - filtered (cm): ");
+  SerialUSB.println(sqrt(squaredError / fixes));
+  SerialUSB.print("Track length raw (m): ");
+  SerialUSB.println(rawLength / 100);
+  SerialUSB.print("Track length filtered (m): ");
+  SerialUSB.println(filteredLength / 100);
+}
+
+void loop() {
+}
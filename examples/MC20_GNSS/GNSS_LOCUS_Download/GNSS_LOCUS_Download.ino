@@ -0,0 +1,81 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_TrackCodec.h"
+
+/* The GNSS logs to its own flash (LOCUS) while nothing else runs, the
+ * log is then pulled in one go and fed to the track codec.
+ */
+
+#define LOG_MINUTES   10
+
+GNSS gnss = GNSS();
+TrackEncoder encoder = TrackEncoder();
+uint32_t encodedBytes = 0;
+
+void onRecord(const GNSS_Fix &fix)
+{
+  uint8_t record[TRACK_MAX_RECORD];
+  char buf[16];
+
+  if(!(fix.flags & FIX_VALID)){
+    return;
+  }
+  encodedBytes += encoder.encode(fix, record, sizeof(record));
+
+  SerialUSB.print(fix.time);
+  SerialUSB.print(",");
+  SerialUSB.print(NMEA_Parser::formatCoordinate(buf, fix.latitude));
+  SerialUSB.print(",");
+  SerialUSB.println(NMEA_Parser::formatCoordinate(buf, fix.longitude));
+}
+
+void printStatus(void)
+{
+  LOCUS_Status status;
+
+  if(gnss.getQueryStatus_LOCUS(&status)){
+    SerialUSB.print("LOCUS records: ");
+    SerialUSB.print(status.records);
+    SerialUSB.print(", flash used: ");
+    SerialUSB.print(status.percent);
+    SerialUSB.println("%");
+  }
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.eraseFlash_LOCUS();
+  gnss.stopLogger_LOCUS(0);     // 0 starts logging
+  printStatus();
+
+  // MCU and GSM could sleep here, the GNSS keeps logging
+  delay(LOG_MINUTES * 60000UL);
+
+  printStatus();
+  if(gnss.queryData_LOCUS(onRecord)){
+    SerialUSB.println("Download OK.");
+  } else {
+    SerialUSB.print("Download incomplete, lost packets: ");
+    SerialUSB.println(gnss.locus.badPackets);
+  }
+  SerialUSB.print("Records: ");
+  SerialUSB.print(gnss.locus.records);
+  SerialUSB.print(", bad: ");
+  SerialUSB.print(gnss.locus.badRecords);
+  SerialUSB.print(", encoded bytes: ");
+  SerialUSB.println(encodedBytes);
+}
+
+void loop() {
+}
@@ -0,0 +1,57 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_FlashStore.h"
+
+/* Warm starts from the last known position. The position survives resets
+ * in a wear-levelled flash region and is written with AT+QGREFLOC on
+ * every open.
+ */
+
+#define AWAKE_MINUTES   2
+#define SLEEP_MINUTES   15
+
+FLASH_STORE_REGION(positionFlash, 8);
+FlashStore positionStore(positionFlash, sizeof(positionFlash));
+GNSS gnss = GNSS();
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  gnss.setPositionStore(&positionStore);
+  gnss.enableNMEAStream(true);
+
+  // First start, no saved position yet: use the serving cell if registered
+  if(!gnss.loadLastPosition() && gnss.isNetworkRegistered()){
+    gnss.setReferenceFromCell();
+  }
+}
+
+void loop() {
+  unsigned long start = millis();
+
+  if(!gnss.open_GNSS(EPO_RL_MODE)){
+    SerialUSB.println("Open GNSS failed.");
+  }
+  SerialUSB.print("Reference: ");
+  SerialUSB.print(gnss.ref_latitude, 6);
+  SerialUSB.print(",");
+  SerialUSB.println(gnss.ref_longitude, 6);
+
+  while(millis() - start < AWAKE_MINUTES * 60000UL){
+    gnss.readNMEAStream();
+    gnss.savePosition();
+  }
+  SerialUSB.print("TTFF ms: ");
+  SerialUSB.println(gnss.lastTTFF);
+
+  // savePosition() keeps to its schedule, save the latest fix before sleeping
+  gnss.saveLastPosition();
+  gnss.close_GNSS();
+  gnss.lastTTFF = 0;
+  delay(SLEEP_MINUTES * 60000UL);
+}
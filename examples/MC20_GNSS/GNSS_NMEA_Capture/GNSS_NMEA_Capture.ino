@@ -0,0 +1,65 @@
+/********************************************************************************************
+ Captures the raw NMEA stream to nmea.txt on the SD card while fixes are parsed as usual.
+ Every line starts with millis() when it arrived. Replay the file with GNSS_Kalman_Replay
+ or feed it to NMEA_Parser in a host build.
+*********************************************************************************************/
+
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_NMEALog.h"
+#include <SPI.h>
+#include <SD.h>
+
+const int chipSelect = 4;
+char* nmeaFileName = "nmea.txt";
+
+GNSS gnss = GNSS();
+NMEA_Recorder recorder = NMEA_Recorder();
+unsigned long lastReport = 0;
+
+void tee(char c)
+{
+  recorder.write(c);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  if(!SD.begin(chipSelect)){
+    SerialUSB.println("SD card initialization failed!");
+    return;
+  }
+  if(!recorder.begin(nmeaFileName)){
+    SerialUSB.println("Can not open nmea.txt");
+    return;
+  }
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.setNMEATee(tee);
+  gnss.enableNMEAStream(true);
+}
+
+void loop() {
+  gnss.readNMEAStream();
+  // At most one block per pass, the parser is never held up for long
+  recorder.service();
+
+  if(millis() - lastReport > 10000){
+    lastReport = millis();
+    SerialUSB.print("Captured ");
+    SerialUSB.print(recorder.bytes);
+    SerialUSB.print(" bytes, dropped ");
+    SerialUSB.print(recorder.overruns);
+    SerialUSB.print(", fixes ");
+    SerialUSB.println(gnss.nmea.epochs);
+  }
+}
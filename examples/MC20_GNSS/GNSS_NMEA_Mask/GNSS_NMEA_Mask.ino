@@ -0,0 +1,51 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+
+#define MEASURE_EPOCHS  10
+
+GNSS gnss = GNSS();
+
+void setup() {
+  uint32_t before, after;
+
+  SerialUSB.begin(115200);
+  while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.enableNMEAStream(true);
+
+  // All sentence types, as shipped
+  gnss.resetNMEAOutput();
+  before = gnss.measureBytesPerEpoch(MEASURE_EPOCHS, 20);
+
+  // Only what the tracker needs
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+  after = gnss.measureBytesPerEpoch(MEASURE_EPOCHS, 20);
+
+  SerialUSB.print("Bytes per epoch, all sentences: ");
+  SerialUSB.println(before);
+  SerialUSB.print("Bytes per epoch, RMC+GGA: ");
+  SerialUSB.println(after);
+  if(before > 0){
+    SerialUSB.print("UART traffic saved: ");
+    SerialUSB.print(100 - after * 100 / before);
+    SerialUSB.println("%");
+  }
+}
+
+void loop() {
+  if(gnss.readNMEAStream() && (gnss.fix.flags & FIX_VALID)){
+    SerialUSB.print("GNSS: ");
+    SerialUSB.print(gnss.str_longitude);
+    SerialUSB.print(",");
+    SerialUSB.println(gnss.str_latitude);
+  }
+}
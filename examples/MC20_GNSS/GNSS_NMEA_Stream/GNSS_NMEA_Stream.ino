@@ -0,0 +1,49 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+
+
+GNSS gnss = GNSS();
+
+void onFix(const GNSS_Fix &fix)
+{
+  char buffer[16];
+
+  if(!(fix.flags & FIX_VALID)){
+    SerialUSB.println("Searching...");
+    return;
+  }
+
+  SerialUSB.print("GNSS: ");
+  SerialUSB.print(NMEA_Parser::formatCoordinate(buffer, fix.longitude));
+  SerialUSB.print(",");
+  SerialUSB.print(NMEA_Parser::formatCoordinate(buffer, fix.latitude));
+  SerialUSB.print(" sats: ");
+  SerialUSB.print(fix.satellites);
+  SerialUSB.print(" speed(cm/s): ");
+  SerialUSB.println(fix.speed);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+
+  SerialUSB.println("Open GNSS OK.");
+
+  while(!gnss.enableNMEAStream(true)){
+    delay(1000);
+  }
+  gnss.setFixCallback(onFix);
+}
+
+void loop() {
+  // No AT+QGNSSRD? round trip, the modem pushes each epoch by itself
+  gnss.readNMEAStream();
+}
@@ -0,0 +1,66 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_Clock.h"
+
+/* UTC with microsecond resolution from the GNSS 1PPS pulse.
+ * Wire the MC20 1PPS output to PPS_PIN, any pin with an external interrupt.
+ */
+
+#define PPS_PIN   2
+
+GNSS gnss = GNSS();
+GNSS_Clock gnssClock = GNSS_Clock();
+
+void onFix(const GNSS_Fix &fix)
+{
+  gnssClock.update(fix);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.set1PPS(true);
+  if(!gnssClock.begin(PPS_PIN)){
+    SerialUSB.println("PPS_PIN has no interrupt.");
+  }
+  gnss.enableNMEAStream(true);
+  gnss.setFixCallback(onFix);
+}
+
+void loop() {
+  static unsigned long lastPrint = 0;
+  uint32_t seconds, microseconds;
+
+  gnss.readNMEAStream();
+
+  if(millis() - lastPrint < 5000){
+    return;
+  }
+  lastPrint = millis();
+
+  if(!gnssClock.now(&seconds, &microseconds)){
+    SerialUSB.println("Waiting for PPS and fix...");
+    return;
+  }
+  SerialUSB.print("UTC: ");
+  SerialUSB.print(seconds);
+  SerialUSB.print(".");
+  for(uint32_t d = 100000; d > 1 && microseconds < d; d /= 10){
+    SerialUSB.print("0");
+  }
+  SerialUSB.print(microseconds);
+  SerialUSB.print(" drift ppb: ");
+  SerialUSB.print(gnssClock.drift());
+  SerialUSB.print(" pulses: ");
+  SerialUSB.println(gnssClock.pulses);
+}
@@ -0,0 +1,112 @@
+#include <math.h>
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+
+/* TTFF across open modes and hot / warm / cold starts.
+ * Every run: restart the receiver with the start type, close it, then time
+ * open_GNSS(mode) until the first fix and until HDOP drops below
+ * HDOP_THRESHOLD. Run it with a clear sky at a surveyed spot, REF_LAT /
+ * REF_LON, and paste the CSV into a spreadsheet.
+ */
+
+#define RUNS            3
+#define FIX_TIMEOUT     300       // seconds per run
+#define HDOP_THRESHOLD  150       // HDOP * 100
+#define OFF_SECONDS     30        // GNSS off between runs
+
+#define REF_LAT         22.584322 // surveyed position of the antenna
+#define REF_LON         113.966678
+
+GNSS gnss = GNSS();
+
+const char *modeName[] = {"default", "epo_quick", "epo_lp", "ref_location"};
+const char *startName[] = {"", "hot", "warm", "cold"};
+
+/* Horizontal error against the reference, centimeters */
+uint32_t errorCm(const GNSS_Fix &fix)
+{
+  double dLat = fix.latitude / 10000000.0 - REF_LAT;
+  double dLon = (fix.longitude / 10000000.0 - REF_LON) * cos(REF_LAT * M_PI / 180.0);
+
+  return (uint32_t)(sqrt(dLat*dLat + dLon*dLon) * 11119500.0);
+}
+
+void runOnce(int mode, int start, int run)
+{
+  unsigned long t0;
+  uint32_t ttff = 0, hdopTime = 0, error = 0;
+  uint32_t nmeaBytes;
+  bool epoFresh;
+
+  // Prepare the start condition, the receiver must be on to take PMTK10x
+  gnss.open_GNSS();
+  gnss.restart(start);
+  delay(2000);
+  gnss.close_GNSS();
+  delay(OFF_SECONDS * 1000UL);
+
+  epoFresh = gnss.isEPOValid();
+  MC20_reset_traffic();
+  nmeaBytes = gnss.nmea.bytes;
+  t0 = millis();
+
+  gnss.open_GNSS(mode);
+  while(millis() - t0 < FIX_TIMEOUT * 1000UL && hdopTime == 0){
+    if(!gnss.readNMEAStream() || !(gnss.fix.flags & FIX_VALID)){
+      continue;
+    }
+    if(ttff == 0){
+      ttff = millis() - t0;
+    }
+    if(gnss.fix.hdop <= HDOP_THRESHOLD){
+      hdopTime = millis() - t0;
+      error = errorCm(gnss.fix);
+    }
+  }
+
+  SerialUSB.print(modeName[mode]);
+  SerialUSB.print(",");
+  SerialUSB.print(startName[start]);
+  SerialUSB.print(",");
+  SerialUSB.print(run);
+  SerialUSB.print(",");
+  SerialUSB.print(epoFresh ? 1 : 0);
+  SerialUSB.print(",");
+  SerialUSB.print(ttff);
+  SerialUSB.print(",");
+  SerialUSB.print(hdopTime);
+  SerialUSB.print(",");
+  SerialUSB.print(error);
+  SerialUSB.print(",");
+  SerialUSB.print(MC20_bytes_sent());
+  SerialUSB.print(",");
+  SerialUSB.print(MC20_bytes_received());
+  SerialUSB.print(",");
+  SerialUSB.println(gnss.nmea.bytes - nmeaBytes);
+
+  gnss.close_GNSS();
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+  gnss.enableNMEAStream(true);
+
+  // 0 in a time column means not reached within FIX_TIMEOUT
+  SerialUSB.println("mode,start,run,epo_fresh,ttff_ms,hdop_ms,error_cm,at_tx_bytes,at_rx_bytes,nmea_bytes");
+  for(int mode = GNSS_DEFAULT_MODE; mode <= EPO_RL_MODE; mode++){
+    for(int start = GNSS_HOT_START; start <= GNSS_COLD_START; start++){
+      for(int run = 0; run < RUNS; run++){
+        runOnce(mode, start, run);
+      }
+    }
+  }
+  SerialUSB.println("Done.");
+}
+
+void loop() {
+}
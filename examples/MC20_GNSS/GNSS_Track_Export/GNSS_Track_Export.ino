@@ -0,0 +1,77 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_TrackLog.h"
+#include "MC20_TrackExport.h"
+#include <SPI.h>
+#include <SD.h>
+
+const int chipSelect = 4;
+
+GNSS gnss = GNSS();
+TrackLogger logger = TrackLogger();
+TrackExporter live = TrackExporter();       // GPX written as fixes come in
+TrackExporter converter = TrackExporter();  // one off conversion of the log
+
+void convertFix(const GNSS_Fix &fix)
+{
+  converter.add(fix);
+}
+
+/* Rewrite the whole binary log as one document, one block in RAM at a time */
+void convertLog(const char *name, TrackExport_Format format)
+{
+  if(SD.exists(name)){
+    SD.remove(name);
+  }
+  if(!converter.begin(name, format)){
+    SerialUSB.print("Can not create ");
+    SerialUSB.println(name);
+    return;
+  }
+  for(uint32_t n = 1; n <= logger.blockCount(); n++){
+    logger.readBlock(n, convertFix);
+  }
+  converter.end();
+
+  SerialUSB.print(name);
+  SerialUSB.print(": ");
+  SerialUSB.print(converter.points);
+  SerialUSB.println(" points");
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  if(!SD.begin(chipSelect)){
+    SerialUSB.println("SD card initialization failed!");
+    return;
+  }
+
+  // Both files are picked up where they were after a reset
+  logger.begin("track.bin");
+  live.begin("live.gpx", EXPORT_GPX);
+
+  convertLog("track.kml", EXPORT_KML);
+  convertLog("track.jsn", EXPORT_GEOJSON);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.enableNMEAStream(true);
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+}
+
+void loop() {
+  if(gnss.readNMEAStream()){
+    logger.log(gnss.fix);
+    // Buffered, the document on the card is rewritten once per chunk
+    live.add(gnss.fix);
+  }
+}
@@ -0,0 +1,122 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_TrackLog.h"
+#include <SPI.h>
+#include <SD.h>
+
+#define BENCH_POINTS    1000
+
+const int chipSelect = 4;
+const char *textFileName = "bench.txt";
+const char *logFileName = "track.bin";
+
+GNSS gnss = GNSS();
+TrackLogger logger = TrackLogger();
+
+/* Synthetic 1 Hz track, about 10 m per point heading north-east */
+void benchFix(GNSS_Fix *fix, uint32_t i)
+{
+  memset(fix, 0, sizeof(*fix));
+  fix->time = 1700000000UL + i;
+  fix->latitude = 225840000L + (int32_t)i * 640;
+  fix->longitude = 1139660000L + (int32_t)i * 690;
+  fix->altitude = 5000 + (i % 7) * 10;
+  fix->speed = 1000;
+  fix->hdop = 90;
+  fix->quality = 1;
+  fix->satellites = 9;
+  fix->flags = FIX_VALID | FIX_HAS_DATE;
+}
+
+void printResult(const char *name, uint32_t ms, uint32_t blocks, uint32_t bytes)
+{
+  SerialUSB.print(name);
+  SerialUSB.print(": ");
+  SerialUSB.print(BENCH_POINTS * 1000UL / (ms ? ms : 1));
+  SerialUSB.print(" points/s, ");
+  SerialUSB.print(blocks);
+  SerialUSB.print(" blocks for ");
+  SerialUSB.print(bytes);
+  SerialUSB.print(" bytes, write amplification x");
+  SerialUSB.println((float)blocks * TRACKLOG_BLOCK_SIZE / bytes, 1);
+}
+
+/* What GNSS_Google_KML does: open, print one line, close on every fix.
+ * Each close writes at least the data block and the directory entry.
+ */
+void benchTextFile(void)
+{
+  GNSS_Fix fix;
+  File file;
+  uint32_t bytes = 0;
+  uint32_t start;
+
+  if(SD.exists(textFileName)){
+    SD.remove(textFileName);
+  }
+  start = millis();
+  for(uint32_t i = 0; i < BENCH_POINTS; i++){
+    benchFix(&fix, i);
+    file = SD.open(textFileName, FILE_WRITE);
+    bytes += file.print(fix.longitude / 1e7, 6);
+    bytes += file.print(",");
+    bytes += file.print(fix.latitude / 1e7, 6);
+    bytes += file.println(",0");
+    file.close();
+  }
+  printResult("open/print/close", millis() - start, BENCH_POINTS * 2, bytes);
+}
+
+void benchTrackLogger(void)
+{
+  GNSS_Fix fix;
+  uint32_t start;
+
+  if(SD.exists(logFileName)){
+    SD.remove(logFileName);
+  }
+  // Preallocation happens here, outside the timed loop
+  if(!logger.begin(logFileName)){
+    SerialUSB.println("TrackLogger begin failed!");
+    return;
+  }
+  start = millis();
+  for(uint32_t i = 0; i < BENCH_POINTS; i++){
+    benchFix(&fix, i);
+    logger.log(fix);
+  }
+  logger.sync();
+  printResult("TrackLogger", millis() - start, logger.blocksWritten, logger.bytesLogged);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  if(!SD.begin(chipSelect)){
+    SerialUSB.println("SD card initialization failed!");
+    return;
+  }
+
+  benchTextFile();
+  benchTrackLogger();
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  // Keep logging real fixes after the bench
+  gnss.enableNMEAStream(true);
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+}
+
+void loop() {
+  if(gnss.readNMEAStream()){
+    logger.log(gnss.fix);
+  }
+}
@@ -0,0 +1,98 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_TrackLog.h"
+#include "MC20_TrackIndex.h"
+#include <SPI.h>
+#include <SD.h>
+
+/* Type "latitude longitude radius_m" on the serial monitor,
+ * e.g. "22.584 113.966 200", to list when the unit was there.
+ */
+
+const int chipSelect = 4;
+
+GNSS gnss = GNSS();
+TrackLogger logger = TrackLogger();
+TrackIndex trackIndex = TrackIndex(logger);
+char command[48];
+uint8_t commandLength = 0;
+
+void printFix(const GNSS_Fix &fix)
+{
+  char str_latitude[16];
+  char str_longitude[16];
+
+  SerialUSB.print(fix.time);
+  SerialUSB.print(" ");
+  SerialUSB.print(NMEA_Parser::formatCoordinate(str_latitude, fix.latitude));
+  SerialUSB.print(",");
+  SerialUSB.println(NMEA_Parser::formatCoordinate(str_longitude, fix.longitude));
+}
+
+void runQuery(void)
+{
+  double latitude, longitude;
+  long radius;
+  uint32_t start, found;
+
+  if(sscanf(command, "%lf %lf %ld", &latitude, &longitude, &radius) != 3){
+    SerialUSB.println("Usage: latitude longitude radius_m");
+    return;
+  }
+  start = millis();
+  found = trackIndex.findNear((int32_t)(latitude * 1e7), (int32_t)(longitude * 1e7), radius, 0, 0, printFix);
+
+  SerialUSB.print(found);
+  SerialUSB.print(" fixes in ");
+  SerialUSB.print(millis() - start);
+  SerialUSB.print(" ms, ");
+  SerialUSB.print(trackIndex.entriesRead);
+  SerialUSB.print(" entries and ");
+  SerialUSB.print(trackIndex.blocksRead);
+  SerialUSB.print(" of ");
+  SerialUSB.print(logger.blockCount());
+  SerialUSB.println(" blocks read");
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  if(!SD.begin(chipSelect)){
+    SerialUSB.println("SD card initialization failed!");
+    return;
+  }
+  logger.begin("track.bin");
+  trackIndex.begin("track.idx");
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.enableNMEAStream(true);
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+}
+
+void loop() {
+  if(gnss.readNMEAStream()){
+    trackIndex.log(gnss.fix);
+  }
+
+  while(SerialUSB.available()){
+    char c = SerialUSB.read();
+    if(c == '\r' || c == '\n'){
+      if(commandLength > 0){
+        command[commandLength] = '\0';
+        runQuery();
+        commandLength = 0;
+      }
+    } else if(commandLength < sizeof(command) - 1){
+      command[commandLength++] = c;
+    }
+  }
+}
@@ -0,0 +1,56 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_TrackSimplify.h"
+#include "MC20_TrackCodec.h"
+
+#define TOLERANCE_M   5     // cross-track tolerance in meters
+#define MAX_GAP_S     300   // keep a point at least every 5 minutes
+
+GNSS gnss = GNSS();
+TrackSimplifier simplifier = TrackSimplifier(TOLERANCE_M, MAX_GAP_S);
+TrackEncoder encoder = TrackEncoder();
+uint32_t encodedBytes = 0;
+
+void onFix(const GNSS_Fix &fix)
+{
+  GNSS_Fix kept;
+  uint8_t record[TRACK_MAX_RECORD];
+
+  if(!simplifier.add(fix, &kept)){
+    return;
+  }
+
+  // Only kept points reach the uplink / SD card
+  encodedBytes += encoder.encode(kept, record, sizeof(record));
+
+  SerialUSB.print("Kept: ");
+  SerialUSB.print(simplifier.keptCount());
+  SerialUSB.print(" dropped: ");
+  SerialUSB.print(simplifier.droppedCount());
+  SerialUSB.print(" (");
+  SerialUSB.print(simplifier.keptPercent());
+  SerialUSB.print("% kept), encoded bytes: ");
+  SerialUSB.println(encodedBytes);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.enableNMEAStream(true);
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+  gnss.setFixCallback(onFix);
+}
+
+void loop() {
+  gnss.readNMEAStream();
+}
@@ -0,0 +1,72 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GNSS.h"
+#include "MC20_Trip.h"
+#include "MC20_FlashStore.h"
+
+/* Odometer and trip statistics kept on the device, saved to flash so they
+ * carry on across resets.
+ */
+
+#define SAVE_MINUTES    5
+#define PRINT_SECONDS   60
+
+FLASH_STORE_REGION(tripFlash, 8);
+FlashStore tripStore(tripFlash, sizeof(tripFlash));
+GNSS gnss = GNSS();
+GNSS_Trip trip = GNSS_Trip();
+
+void onFix(const GNSS_Fix &fix)
+{
+  trip.update(fix);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  if(trip.load(tripStore)){
+    SerialUSB.println("Trip restored.");
+  }
+
+  gnss.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+
+  gnss.enableNMEAStream(true);
+  gnss.setFixCallback(onFix);
+}
+
+void loop() {
+  static unsigned long lastPrint = 0;
+  static unsigned long lastSave = 0;
+
+  gnss.readNMEAStream();
+
+  if(millis() - lastSave > SAVE_MINUTES * 60000UL){
+    lastSave = millis();
+    trip.save(tripStore);
+  }
+
+  if(millis() - lastPrint > PRINT_SECONDS * 1000UL){
+    lastPrint = millis();
+    SerialUSB.print("Trip m: ");
+    SerialUSB.print(trip.distance());
+    SerialUSB.print(" odometer m: ");
+    SerialUSB.print(trip.odometer());
+    SerialUSB.print(" moving s: ");
+    SerialUSB.print(trip.movingTime());
+    SerialUSB.print(" idle s: ");
+    SerialUSB.print(trip.idleTime());
+    SerialUSB.print(" max/avg cm/s: ");
+    SerialUSB.print(trip.maxSpeed());
+    SerialUSB.print("/");
+    SerialUSB.print(trip.averageSpeed());
+    SerialUSB.print(" stops: ");
+    SerialUSB.println(trip.stops());
+  }
+}
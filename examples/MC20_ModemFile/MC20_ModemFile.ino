@@ -0,0 +1,76 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+
+/* Keeps a backlog of records in the modem's file system instead of MCU RAM:
+ * 200 records of 64 bytes (12.8 KB) go through a 64 byte buffer.
+ */
+
+#define RECORDS      200
+#define RECORD_SIZE  64
+
+GPSTracker gpsTracker = GPSTracker();
+const char *backlogName = "backlog.bin";
+uint8_t record[RECORD_SIZE];
+
+void setup() {
+  long handle, freeBytes, totalBytes, n;
+  uint32_t count = 0;
+  uint32_t timerStart;
+
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gpsTracker.Power_On();
+  SerialUSB.println("Power On!");
+  while(!gpsTracker.init()){
+    delay(1000);
+  }
+
+  if(gpsTracker.fileSpace("UFS", &freeBytes, &totalBytes)){
+    SerialUSB.print("UFS free: ");
+    SerialUSB.print(freeBytes);
+    SerialUSB.print(" of ");
+    SerialUSB.println(totalBytes);
+  }
+
+  // Append records, e.g. fixes waiting for coverage
+  handle = gpsTracker.fileOpen(backlogName, MC20_FILE_CREATE);
+  if(handle < 0){
+    SerialUSB.println("Open failed!");
+    return;
+  }
+  timerStart = millis();
+  for(int i = 0; i < RECORDS; i++){
+    memset(record, i, sizeof(record));
+    if(gpsTracker.fileWrite(handle, record, sizeof(record)) != sizeof(record)){
+      SerialUSB.println("Write failed!");
+      break;
+    }
+  }
+  SerialUSB.print("Written in ");
+  SerialUSB.print(millis() - timerStart);
+  SerialUSB.println(" ms");
+
+  // Stream it back, one record in RAM at a time
+  gpsTracker.fileSeek(handle, 0);
+  timerStart = millis();
+  while((n = gpsTracker.fileRead(handle, record, sizeof(record))) > 0){
+    if(record[0] != (uint8_t)count || record[n - 1] != (uint8_t)count){
+      SerialUSB.print("Bad record ");
+      SerialUSB.println(count);
+    }
+    count++;
+  }
+  gpsTracker.fileClose(handle);
+
+  SerialUSB.print(count);
+  SerialUSB.print(" records read in ");
+  SerialUSB.print(millis() - timerStart);
+  SerialUSB.print(" ms, file size ");
+  SerialUSB.println(gpsTracker.fileSize(backlogName));
+
+  gpsTracker.fileDelete(backlogName);
+}
+
+void loop() {
+}
@@ -0,0 +1,71 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GPRS.h"
+#include "MC20_Connection.h"
+
+/* Telemetry uplink and config downlink on two sockets at the same time */
+
+GPRS gprs = GPRS();
+const char apn[10] = "CMNET";
+const char uplinkHost[] = "example.com";
+const char configHost[] = "example.com";
+
+TCPConnection uplink = TCPConnection(gprs, uplinkHost, 7);
+int configSocket = -1;
+unsigned long lastSend = 0;
+
+/* Data of every socket arrives here, the index tells them apart */
+void onData(uint8_t socket, const uint8_t *data, size_t length)
+{
+  if(socket != configSocket){
+    return;
+  }
+  SerialUSB.print("Config: ");
+  SerialUSB.write(data, length);
+  SerialUSB.println();
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gprs.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gprs.init(apn)){
+    delay(1000);
+  }
+  // Before join(), the modem refuses it with an active context
+  if(!gprs.enableMux(true)){
+    SerialUSB.println("AT+QIMUX failed!");
+  }
+  while(!gprs.join()){
+    delay(1000);
+  }
+  SerialUSB.print("\n\rIP: ");
+  SerialUSB.println(gprs.ip_string);
+
+  gprs.setDataCallback(onData);
+  configSocket = gprs.openSocket(TCP, configHost, 8080);
+  if(configSocket >= 0){
+    gprs.sendSocket(configSocket, "GET CONFIG\r\n");
+  }
+}
+
+void loop() {
+  char message[32];
+
+  // Routes received data and notices closed sockets
+  uplink.maintain();
+
+  if(configSocket >= 0 && !gprs.isSocketOpen(configSocket)){
+    SerialUSB.println("Config socket closed");
+    configSocket = -1;
+  }
+
+  if(millis() - lastSend > 10000){
+    lastSend = millis();
+    sprintf(message, "uptime %lu\r\n", millis() / 1000);
+    uplink.send(message);
+  }
+}
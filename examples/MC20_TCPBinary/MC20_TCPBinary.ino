@@ -0,0 +1,90 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GPRS.h"
+#include "MC20_GNSS.h"
+#include "MC20_TrackCodec.h"
+
+/* Sends batches of encoded fixes as binary frames: a 4 byte header,
+ * the batch and a 1 byte checksum go out as three buffers in one send.
+ */
+
+#define BATCH_FIXES   30
+
+GPRS gprs = GPRS();
+GNSS gnss = GNSS();
+TrackEncoder encoder = TrackEncoder();
+const char apn[10] = "CMNET";
+const char host[] = "example.com";
+int port = 7;
+
+GNSS_Fix fixes[BATCH_FIXES];
+uint8_t fixCount = 0;
+uint8_t batch[BATCH_FIXES * TRACK_MAX_RECORD];
+
+void sendBatch(void)
+{
+  uint8_t header[4];
+  uint8_t checksum = 0;
+  size_t length = encoder.encodeBatch(fixes, fixCount, batch, sizeof(batch));
+
+  // Binary: zeros, '\r' and '\n' in the payload are fine
+  header[0] = 0xB7;
+  header[1] = 0x01;
+  header[2] = length >> 8;
+  header[3] = length & 0xFF;
+  for(size_t i = 0; i < length; i++){
+    checksum ^= batch[i];
+  }
+
+  GPRS_Buffer frame[3] = {
+    {header, sizeof(header)},
+    {batch, length},
+    {&checksum, 1},
+  };
+  if(!gprs.tcpConnected && !gprs.connectTCP(host, port)){
+    SerialUSB.println("Connect Error!");
+    return;
+  }
+  if(gprs.send(frame, 3) && gprs.waitAcked()){
+    SerialUSB.print("Sent and acknowledged ");
+    SerialUSB.print(length + 5);
+    SerialUSB.println(" bytes");
+  } else {
+    SerialUSB.println("Send Error!");
+    gprs.closeTCP();
+  }
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gprs.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gprs.init(apn)){
+    delay(1000);
+  }
+  while(!gprs.join()){
+    delay(1000);
+  }
+  SerialUSB.print("\n\rIP: ");
+  SerialUSB.println(gprs.ip_string);
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+  gnss.enableNMEAStream(true);
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+}
+
+void loop() {
+  if(gnss.readNMEAStream() && (gnss.fix.flags & FIX_VALID)){
+    fixes[fixCount++] = gnss.fix;
+    if(fixCount == BATCH_FIXES){
+      sendBatch();
+      fixCount = 0;
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GPRS.h"
+#include "MC20_Connection.h"
+
+/* Sends a message every 10 seconds over one TCP connection that is kept
+ * open, and shows how the connection setup is amortized over the messages.
+ */
+
+GPRS gprs = GPRS();
+const char apn[10] = "CMNET";
+const char host[] = "example.com";
+int port = 7;
+
+TCPConnection connection = TCPConnection(gprs, host, port);
+unsigned long lastSend = 0;
+uint32_t counter = 0;
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gprs.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gprs.init(apn)){
+    delay(1000);
+  }
+  while(!gprs.join()){
+    delay(1000);
+  }
+  SerialUSB.print("\n\rIP: ");
+  SerialUSB.println(gprs.ip_string);
+}
+
+void loop() {
+  char message[32];
+
+  connection.maintain();
+
+  if(millis() - lastSend < 10000){
+    return;
+  }
+  lastSend = millis();
+
+  sprintf(message, "message %lu\r\n", (unsigned long)counter++);
+  if(!connection.send(message)){
+    SerialUSB.println("Not sent, will retry");
+  }
+
+  SerialUSB.print("messages: ");
+  SerialUSB.print(connection.messages);
+  SerialUSB.print(" opens: ");
+  SerialUSB.print(connection.connects);
+  SerialUSB.print(" failed: ");
+  SerialUSB.print(connection.failures);
+  SerialUSB.print(" drops: ");
+  SerialUSB.print(connection.drops);
+  SerialUSB.print(" setup ms/message: ");
+  SerialUSB.println(connection.setupTimePerMessage());
+}
@@ -0,0 +1,74 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GPRS.h"
+
+/* Keeps a TCP connection open and takes line commands from the server,
+ * e.g. "interval 30". Received data stays in the modem until read, so
+ * commands never mix with AT responses and loop() is not blocked waiting.
+ */
+
+GPRS gprs = GPRS();
+const char apn[10] = "CMNET";
+const char host[] = "example.com";
+int port = 7;
+
+char command[64];
+uint8_t commandLength = 0;
+unsigned long interval = 10;
+unsigned long lastSend = 0;
+
+void handleCommand(const char *line) {
+  SerialUSB.print("command: ");
+  SerialUSB.println(line);
+  if(0 == strncmp(line, "interval ", 9)){
+    interval = strtoul(line + 9, NULL, 10);
+  }
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gprs.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gprs.init(apn)){
+    delay(1000);
+  }
+  gprs.enableReceiveBuffer(true);
+  while(!gprs.join()){
+    delay(1000);
+  }
+  while(!gprs.connectTCP(host, port)){
+    delay(5000);
+  }
+  SerialUSB.println("Connected");
+}
+
+void loop() {
+  int c;
+
+  // available() polls and pulls what the modem announced
+  if(gprs.available() > 0){
+    while((c = gprs.read()) >= 0){
+      if(c == '\r' || c == '\n'){
+        if(commandLength > 0){
+          command[commandLength] = '\0';
+          commandLength = 0;
+          handleCommand(command);
+        }
+      } else if(commandLength < sizeof(command) - 1){
+        command[commandLength++] = c;
+      }
+    }
+  }
+
+  if(!gprs.tcpConnected){
+    gprs.connectTCP(host, port);
+    return;
+  }
+  if(millis() - lastSend > interval * 1000){
+    lastSend = millis();
+    gprs.sendTCPData((char *)"ping\r\n");
+  }
+}
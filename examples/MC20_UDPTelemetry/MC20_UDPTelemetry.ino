@@ -0,0 +1,77 @@
+#include "MC20_Common.h"
+#include "MC20_Arduino_Interface.h"
+#include "MC20_GPRS.h"
+#include "MC20_GNSS.h"
+#include "MC20_Telemetry.h"
+
+/* Reports fixes over UDP, 8 per datagram. The server answers each
+ * datagram with 0xB7 0x82 <sequence>, missing answers are retransmitted.
+ */
+
+GPRS gprs = GPRS();
+GNSS gnss = GNSS();
+const char apn[10] = "CMNET";
+const char host[] = "example.com";
+int port = 9000;
+
+UDPTelemetry telemetry = UDPTelemetry(gprs, host, port);
+unsigned long lastReport = 0;
+
+// The NMEA stream and the GPRS URCs share the UART, readNMEAStream() reads
+// both and hands the URCs (the "+QIRDI" of an ack) over to GPRS
+void onURC(const char *line) {
+  gprs.handleLine(line);
+}
+
+void setup() {
+  SerialUSB.begin(115200);
+  // while(!SerialUSB);
+
+  gprs.Power_On();
+  SerialUSB.println("\n\rPower On!");
+
+  while(!gprs.init(apn)){
+    delay(1000);
+  }
+  // Acks are pulled with AT+QIRD instead of arriving in the AT stream
+  gprs.enableReceiveBuffer(true);
+  while(!gprs.join()){
+    delay(1000);
+  }
+  SerialUSB.print("\n\rIP: ");
+  SerialUSB.println(gprs.ip_string);
+
+  telemetry.setAckWindow(4);
+  while(!telemetry.begin()){
+    delay(1000);
+  }
+
+  while(!gnss.open_GNSS(GNSS_DEFAULT_MODE)){
+    delay(1000);
+  }
+  SerialUSB.println("Open GNSS OK.");
+  gnss.setURCHandler(onURC);
+  gnss.enableNMEAStream(true);
+  gnss.setNMEASentences(NMEA_RMC | NMEA_GGA);
+}
+
+void loop() {
+  if(gnss.readNMEAStream() && (gnss.fix.flags & FIX_VALID)){
+    telemetry.add(gnss.fix);
+  }
+  telemetry.service();
+
+  if(millis() - lastReport > 60000){
+    lastReport = millis();
+    SerialUSB.print("datagrams: ");
+    SerialUSB.print(telemetry.datagrams);
+    SerialUSB.print(" bytes: ");
+    SerialUSB.print(telemetry.bytesSent);
+    SerialUSB.print(" acked: ");
+    SerialUSB.print(telemetry.acked);
+    SerialUSB.print(" retransmits: ");
+    SerialUSB.print(telemetry.retransmits);
+    SerialUSB.print(" lost: ");
+    SerialUSB.println(telemetry.lost);
+  }
+}